@@ -0,0 +1,447 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	/*
+		Concurrent two-dimensional bit matrix (e.g. a graph's adjacency matrix).
+
+		Rows are padded to a whole number of words and laid out back-to-back across
+		`fixed_size_atomic_page`s, so row-wide operations run over contiguous words.
+		The matrix's dimensions are fixed at construction.
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store binary data.
+		typename T,
+
+		// Controls the number of elements allocated for each page of memory.
+		std::size_t fixed_page_size
+	>
+	class basic_atomic_bit_matrix
+	{
+		public:
+			using underlying_type = T;
+
+			using atomic_type    = std::atomic<underlying_type>;
+			using element_type   = atomic_type;
+			using page_type      = fixed_size_atomic_page<underlying_type, fixed_page_size, element_type>;
+			using container_type = std::vector<page_type>;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using row_index_t    = size_t;
+			using column_index_t = size_t;
+			using word_index_t   = size_t;
+
+			inline static constexpr size_t page_size = static_cast<size_t>(fixed_page_size);
+
+			inline static constexpr size_t bits_per_byte = 8;
+			inline static constexpr size_t bit_stride    = (sizeof(underlying_type) * bits_per_byte);
+
+			basic_atomic_bit_matrix(size_t row_count, size_t column_count) :
+				row_count(row_count),
+				column_count(column_count),
+				row_stride((column_count + (bit_stride - static_cast<size_t>(1))) / bit_stride)
+			{
+				const auto word_count = (row_count * row_stride);
+				const auto page_count = ((word_count + (page_size - static_cast<size_t>(1))) / page_size);
+
+				pages.reserve(page_count);
+
+				for (auto page_index = size_t {}; page_index < page_count; page_index++)
+				{
+					pages.emplace_back(underlying_type {});
+				}
+			}
+
+			basic_atomic_bit_matrix(basic_atomic_bit_matrix&&) noexcept = default;
+			basic_atomic_bit_matrix& operator=(basic_atomic_bit_matrix&&) noexcept = default;
+
+			basic_atomic_bit_matrix(const basic_atomic_bit_matrix&) = delete;
+			basic_atomic_bit_matrix& operator=(const basic_atomic_bit_matrix&) = delete;
+
+			size_t rows() const
+			{
+				return row_count;
+			}
+
+			size_t columns() const
+			{
+				return column_count;
+			}
+
+			// The number of words occupied by each row.
+			size_t words_per_row() const
+			{
+				return row_stride;
+			}
+
+			value_type get(row_index_t row, column_index_t column) const
+			{
+				assert(column < column_count);
+
+				const auto& element = get_word(row, resolve_word_offset(column));
+
+				return ((element.load() & make_bit_mask(column)) != underlying_type {});
+			}
+
+			underlying_type set(row_index_t row, column_index_t column, value_type value)
+			{
+				return (value)
+					? enable(row, column)
+					: disable(row, column)
+				;
+			}
+
+			underlying_type enable(row_index_t row, column_index_t column)
+			{
+				assert(column < column_count);
+
+				return get_word(row, resolve_word_offset(column)).fetch_or(make_bit_mask(column));
+			}
+
+			underlying_type disable(row_index_t row, column_index_t column)
+			{
+				assert(column < column_count);
+
+				return get_word(row, resolve_word_offset(column)).fetch_and(static_cast<underlying_type>(~make_bit_mask(column)));
+			}
+
+			// Atomically merges the contents of row `source` into row `destination`, word-by-word.
+			void row_or(row_index_t destination, row_index_t source)
+			{
+				for_each_row_word_pair
+				(
+					destination, source,
+
+					[](element_type& destination_word, underlying_type source_word)
+					{
+						if (source_word != underlying_type {})
+						{
+							destination_word.fetch_or(source_word);
+						}
+					}
+				);
+			}
+
+			// Atomically intersects row `destination` with row `source`, word-by-word.
+			void row_and(row_index_t destination, row_index_t source)
+			{
+				for_each_row_word_pair
+				(
+					destination, source,
+
+					[](element_type& destination_word, underlying_type source_word)
+					{
+						if (source_word != static_cast<underlying_type>(~underlying_type {}))
+						{
+							destination_word.fetch_and(source_word);
+						}
+					}
+				);
+			}
+
+			// The number of set bits in `row`.
+			size_t row_population(row_index_t row) const
+			{
+				auto result = size_t {};
+
+				for_each_row_segment
+				(
+					row,
+
+					[&result](const element_type* words, size_t, size_t word_count)
+					{
+						for (auto word_index = size_t {}; word_index < word_count; word_index++)
+						{
+							result += static_cast<size_t>(std::popcount(words[word_index].load(std::memory_order_relaxed)));
+						}
+					}
+				);
+
+				return result;
+			}
+
+			// The number of set bits in `column` (i.e. a row of the transposed matrix).
+			size_t column_population(column_index_t column) const
+			{
+				auto result = size_t {};
+
+				for_each_in_column
+				(
+					column,
+
+					[&result](row_index_t)
+					{
+						result++;
+					}
+				);
+
+				return result;
+			}
+
+			// Executes `callback(column)` for each set bit in `row`.
+			template <typename Callback>
+			void for_each_in_row(row_index_t row, Callback&& callback) const
+			{
+				for_each_row_segment
+				(
+					row,
+
+					[&callback](const element_type* words, size_t first_word, size_t word_count)
+					{
+						for (auto word_index = size_t {}; word_index < word_count; word_index++)
+						{
+							auto word = words[word_index].load(std::memory_order_relaxed);
+
+							while (word)
+							{
+								const auto bit_offset = static_cast<size_t>(std::countr_zero(word));
+
+								word &= static_cast<underlying_type>(word - static_cast<underlying_type>(1));
+
+								callback(static_cast<column_index_t>(((first_word + word_index) * bit_stride) + bit_offset));
+							}
+						}
+					}
+				);
+			}
+
+			// Executes `callback(row)` for each row with `column` set (i.e. a row of the transposed matrix).
+			template <typename Callback>
+			void for_each_in_column(column_index_t column, Callback&& callback) const
+			{
+				assert(column < column_count);
+
+				const auto word_offset = resolve_word_offset(column);
+				const auto bitmask = make_bit_mask(column);
+
+				for (auto row = row_index_t {}; row < row_count; row++)
+				{
+					if ((get_word(row, word_offset).load(std::memory_order_relaxed) & bitmask) != underlying_type {})
+					{
+						callback(row);
+					}
+				}
+			}
+
+			/*
+				Top-down frontier expansion: `next |= adjacency[u] & ~visited` for each `u` in `frontier`.
+
+				Only rows in [`first_row`, `last_row`) are visited, allowing the work to be split between threads.
+				`frontier`, `visited` and `next` are bitsets indexed by vertex (e.g. `basic_atomic_bitset`) with storage
+				allocated for at least `columns()` bits. Whole rows are processed a word at a time; words of `next`
+				are updated with a single `fetch_or` each.
+
+				Returns the number of vertices newly added to `next` by this call.
+			*/
+			template <typename BitsetType>
+			size_t expand_frontier(const BitsetType& frontier, const BitsetType& visited, BitsetType& next, row_index_t first_row, row_index_t last_row) const
+			{
+				static_assert((BitsetType::bit_stride == bit_stride), "Vertex bitsets must use words of the same width as the matrix");
+
+				auto discovered = size_t {};
+
+				last_row = std::min(last_row, row_count);
+
+				for (auto row = first_row; row < last_row; row++)
+				{
+					if (!frontier.get(row))
+					{
+						continue;
+					}
+
+					for_each_row_segment
+					(
+						row,
+
+						[&visited, &next, &discovered](const element_type* words, size_t first_word, size_t word_count)
+						{
+							for (auto word_offset = size_t {}; word_offset < word_count; word_offset++)
+							{
+								const auto word_index = static_cast<word_index_t>(first_word + word_offset);
+
+								const auto candidates = static_cast<underlying_type>
+								(
+									words[word_offset].load(std::memory_order_relaxed)
+									&
+									~visited.get_word(word_index).load(std::memory_order_relaxed)
+								);
+
+								if (candidates == underlying_type {})
+								{
+									continue;
+								}
+
+								const auto previous_value = next.fetch_or_mask(word_index, candidates);
+
+								discovered += static_cast<size_t>(std::popcount(static_cast<underlying_type>(candidates & ~previous_value)));
+							}
+						}
+					);
+				}
+
+				return discovered;
+			}
+
+			template <typename BitsetType>
+			size_t expand_frontier(const BitsetType& frontier, const BitsetType& visited, BitsetType& next) const
+			{
+				return expand_frontier(frontier, visited, next, row_index_t {}, row_count);
+			}
+
+			/*
+				Bottom-up frontier expansion: each unvisited vertex `v` in [`first_row`, `last_row`) joins `next`
+				if `adjacency[v] & frontier` is non-empty. Row `v` is treated as `v`'s incoming edges,
+				so this expects a symmetric (undirected) matrix, or the transpose of a directed one.
+
+				Returns the number of vertices added to `next` by this call.
+			*/
+			template <typename BitsetType>
+			size_t expand_frontier_bottom_up(const BitsetType& frontier, const BitsetType& visited, BitsetType& next, row_index_t first_row, row_index_t last_row) const
+			{
+				static_assert((BitsetType::bit_stride == bit_stride), "Vertex bitsets must use words of the same width as the matrix");
+
+				auto discovered = size_t {};
+
+				last_row = std::min(last_row, row_count);
+
+				for (auto row = first_row; row < last_row; row++)
+				{
+					if (visited.get(row))
+					{
+						continue;
+					}
+
+					auto has_parent = false;
+
+					for_each_row_segment
+					(
+						row,
+
+						[&frontier, &has_parent](const element_type* words, size_t first_word, size_t word_count)
+						{
+							for (auto word_offset = size_t {}; ((word_offset < word_count) && (!has_parent)); word_offset++)
+							{
+								const auto word_index = static_cast<word_index_t>(first_word + word_offset);
+
+								has_parent =
+								(
+									(words[word_offset].load(std::memory_order_relaxed) & frontier.get_word(word_index).load(std::memory_order_relaxed))
+									!=
+									underlying_type {}
+								);
+							}
+						}
+					);
+
+					if (!has_parent)
+					{
+						continue;
+					}
+
+					const auto previous_value = next.enable(row);
+
+					if ((previous_value & make_bit_mask(row)) == underlying_type {})
+					{
+						discovered++;
+					}
+				}
+
+				return discovered;
+			}
+
+			template <typename BitsetType>
+			size_t expand_frontier_bottom_up(const BitsetType& frontier, const BitsetType& visited, BitsetType& next) const
+			{
+				return expand_frontier_bottom_up(frontier, visited, next, row_index_t {}, row_count);
+			}
+
+		protected:
+			static constexpr word_index_t resolve_word_offset(column_index_t column)
+			{
+				return static_cast<word_index_t>(column / bit_stride);
+			}
+
+			static constexpr underlying_type make_bit_mask(column_index_t column)
+			{
+				return static_cast<underlying_type>(static_cast<underlying_type>(1) << static_cast<underlying_type>(column % bit_stride));
+			}
+
+			element_type& get_word(row_index_t row, word_index_t word_offset)
+			{
+				assert(row < row_count);
+
+				const auto word_index = ((row * row_stride) + word_offset);
+
+				return pages[(word_index / page_size)].data()[(word_index % page_size)];
+			}
+
+			const element_type& get_word(row_index_t row, word_index_t word_offset) const
+			{
+				assert(row < row_count);
+
+				const auto word_index = ((row * row_stride) + word_offset);
+
+				return pages[(word_index / page_size)].data()[(word_index % page_size)];
+			}
+
+			/*
+				Executes `callback(words, first_word, word_count)` for each run of `row`'s words that's contiguous in memory.
+				`first_word` is the offset of `words[0]` within the row (and therefore, its column word index).
+			*/
+			template <typename Callback>
+			void for_each_row_segment(row_index_t row, Callback&& callback) const
+			{
+				assert(row < row_count);
+
+				const auto row_begin = (row * row_stride);
+				const auto row_end = (row_begin + row_stride);
+
+				for (auto word_index = row_begin; word_index < row_end; )
+				{
+					const auto element_index = (word_index % page_size);
+					const auto word_count = std::min((page_size - element_index), (row_end - word_index));
+
+					const auto* words = (pages[(word_index / page_size)].data() + element_index);
+
+					callback(words, (word_index - row_begin), word_count);
+
+					word_index += word_count;
+				}
+			}
+
+			template <typename Callback>
+			void for_each_row_word_pair(row_index_t destination, row_index_t source, Callback&& callback)
+			{
+				for (auto word_offset = word_index_t {}; word_offset < row_stride; word_offset++)
+				{
+					const auto source_word = get_word(source, word_offset).load(std::memory_order_relaxed);
+
+					callback(get_word(destination, word_offset), source_word);
+				}
+			}
+
+			size_t row_count;
+			size_t column_count;
+			size_t row_stride;
+
+			container_type pages;
+	};
+
+	// Defaults to 64-bit unsigned integers: 512 x 8 x 8 (4096 bytes, 32768 bits)
+	using atomic_bit_matrix = basic_atomic_bit_matrix<std::uint64_t, 512>;
+}
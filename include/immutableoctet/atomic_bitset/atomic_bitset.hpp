@@ -4,16 +4,33 @@
 #include <type_traits>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
 #include <vector>
 #include <memory>
 #include <tuple>
 #include <array>
 #include <iterator>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <bit>
 
 #include <cstdint>
 #include <cstddef>
 #include <cassert>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <xmmintrin.h>
+#endif
+
+#if defined(__AVX512F__)
+	#include <immintrin.h>
+#endif
+
 namespace immutableoctet
 {
 	namespace impl
@@ -122,6 +139,217 @@ namespace immutableoctet
 
 			return (value & bitmask);
 		}
+
+		// Builds a mask of `bit_count` consecutive bits, starting at `bit_offset`.
+		template <typename T>
+		constexpr T make_bit_range_mask(std::size_t bit_offset, std::size_t bit_count)
+		{
+			static_assert((std::is_unsigned_v<T>), "`T` must be an unsigned integral type");
+
+			constexpr auto bit_width = static_cast<std::size_t>(std::numeric_limits<T>::digits);
+
+			if (bit_count == 0)
+			{
+				return {};
+			}
+
+			if (bit_count >= bit_width)
+			{
+				return static_cast<T>(~T {});
+			}
+
+			return static_cast<T>(((static_cast<T>(1) << bit_count) - static_cast<T>(1)) << bit_offset);
+		}
+
+		// Enables every bit in `mask`, but only if none of them are currently enabled.
+		template <typename T>
+		bool compare_and_set_mask(std::atomic<T>& element, T mask)
+		{
+			static_assert((std::is_integral<std::decay_t<T>>::value), "`T` must be an integral type");
+
+			auto value = element.load();
+
+			do
+			{
+				if ((value & mask) != T {})
+				{
+					return false;
+				}
+			}
+			while (!element.compare_exchange_weak(value, static_cast<T>(value | mask)));
+
+			return true;
+		}
+
+		// Placeholder member type used in place of disabled optional features.
+		struct disabled_feature {};
+
+		// Atomic padded out to its own cache line, so that neighbouring values don't share one.
+		template <typename T>
+		struct alignas(64) padded_atomic : std::atomic<T>
+		{
+			using std::atomic<T>::atomic;
+		};
+
+		/*
+			Append-only table whose entries never move once allocated, so that they can be accessed
+			without a lock while the table grows (unlike a `std::vector`, which reallocates).
+
+			Entries are held in segments of doubling size (1, 2, 4, ...), each allocated on demand.
+			Growth must be serialized by the caller, and an entry must only be accessed once
+			its index has been published to other threads (e.g. by the page it describes).
+		*/
+		template <typename T>
+		class segmented_table
+		{
+			public:
+				segmented_table() = default;
+
+				~segmented_table()
+				{
+					for (auto& segment : segments)
+					{
+						delete[] segment.load(std::memory_order_relaxed);
+					}
+				}
+
+				segmented_table(const segmented_table&) = delete;
+				segmented_table& operator=(const segmented_table&) = delete;
+
+				// Allocates segments until the table holds at least `entry_count` value-initialized entries.
+				void reserve(std::size_t entry_count)
+				{
+					while (allocated_entries < entry_count)
+					{
+						const auto segment_index = static_cast<std::size_t>(std::bit_width(allocated_entries + 1) - 1);
+						const auto segment_size = (static_cast<std::size_t>(1) << segment_index);
+
+						segments[segment_index].store(new T[segment_size] {}, std::memory_order_release);
+
+						allocated_entries += segment_size;
+					}
+				}
+
+				T& operator[](std::size_t index) const
+				{
+					const auto position = (index + 1);
+					const auto segment_index = static_cast<std::size_t>(std::bit_width(position) - 1);
+
+					return segments[segment_index].load(std::memory_order_acquire)[(position - (static_cast<std::size_t>(1) << segment_index))];
+				}
+
+				std::size_t capacity() const
+				{
+					return allocated_entries;
+				}
+
+			private:
+				std::array<std::atomic<T*>, std::numeric_limits<std::size_t>::digits> segments = {};
+
+				std::size_t allocated_entries = 0;
+		};
+
+		// Hints that the cache line containing `address` will be read soon.
+		inline void prefetch(const void* address)
+		{
+			#if defined(__GNUC__) || defined(__clang__)
+				__builtin_prefetch(address);
+			#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+				_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+			#else
+				static_cast<void>(address);
+			#endif
+		}
+
+		// For each possible byte, the offsets of its set bits, in ascending order (unused entries are zero).
+		inline constexpr auto byte_bit_offsets = []()
+		{
+			auto table = std::array<std::array<std::uint8_t, 8>, 256> {};
+
+			for (auto byte_value = std::size_t {}; byte_value < table.size(); byte_value++)
+			{
+				auto offset_count = std::size_t {};
+
+				for (auto bit_offset = std::size_t {}; bit_offset < 8; bit_offset++)
+				{
+					if ((byte_value >> bit_offset) & 1)
+					{
+						table[byte_value][offset_count++] = static_cast<std::uint8_t>(bit_offset);
+					}
+				}
+			}
+
+			return table;
+		}();
+
+		/*
+			Writes `base + i` to `out` for each set bit `i` of `word`, in ascending order, returning the number of indices written.
+
+			`out` must have room for one index per bit of `word`: entries beyond the returned count may be overwritten.
+			Each byte of `word` is expanded with a fixed number of stores (masked compress stores with AVX-512),
+			so dense words don't incur a branch per set bit.
+		*/
+		template <typename T, typename IndexType>
+		inline std::size_t expand_word_indices(T word, IndexType base, IndexType* out)
+		{
+			static_assert((std::is_unsigned_v<T>), "`T` must be an unsigned integral type");
+
+			constexpr auto byte_count = sizeof(T);
+
+			const auto index_count = static_cast<std::size_t>(std::popcount(word));
+
+			// Sparse words: the bit-clearing loop is cheaper than expanding every byte.
+			if (index_count <= byte_count)
+			{
+				for (auto index_offset = std::size_t {}; index_offset < index_count; index_offset++)
+				{
+					out[index_offset] = static_cast<IndexType>(base + static_cast<IndexType>(std::countr_zero(word)));
+
+					word &= static_cast<T>(word - static_cast<T>(1));
+				}
+
+				return index_count;
+			}
+
+			auto written = std::size_t {};
+
+			#if defined(__AVX512F__)
+				if constexpr (sizeof(IndexType) == sizeof(std::uint64_t))
+				{
+					const auto lane_offsets = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+
+					for (auto byte_index = std::size_t {}; byte_index < byte_count; byte_index++)
+					{
+						const auto byte_value = static_cast<__mmask8>(word >> (byte_index * 8));
+						const auto byte_base = _mm512_set1_epi64(static_cast<long long>(base + static_cast<IndexType>(byte_index * 8)));
+
+						_mm512_mask_compressstoreu_epi64((out + written), byte_value, _mm512_add_epi64(byte_base, lane_offsets));
+
+						written += static_cast<std::size_t>(std::popcount(static_cast<std::uint8_t>(byte_value)));
+					}
+
+					return written;
+				}
+			#endif
+
+			for (auto byte_index = std::size_t {}; byte_index < byte_count; byte_index++)
+			{
+				const auto byte_value = static_cast<std::uint8_t>(word >> (byte_index * 8));
+				const auto& offsets = byte_bit_offsets[byte_value];
+
+				const auto byte_base = static_cast<IndexType>(base + static_cast<IndexType>(byte_index * 8));
+
+				// Always store all 8 entries; only the first `popcount(byte_value)` are kept.
+				for (auto offset_index = std::size_t {}; offset_index < offsets.size(); offset_index++)
+				{
+					out[written + offset_index] = static_cast<IndexType>(byte_base + static_cast<IndexType>(offsets[offset_index]));
+				}
+
+				written += static_cast<std::size_t>(std::popcount(byte_value));
+			}
+
+			return written;
+		}
 	}
 
 	template <typename T, std::size_t page_size, typename AtomicType=std::atomic<T>>
@@ -204,6 +432,231 @@ namespace immutableoctet
 			}
 	};
 
+	// Counters reported by `spare_page_pool`.
+	struct page_pool_stats
+	{
+		// The number of pages handed out from the pool.
+		std::size_t hits = {};
+
+		// The number of times a page was requested while the pool was empty (or busy), and had to be allocated on the spot.
+		std::size_t misses = {};
+
+		// The number of pages allocated ahead of time by the pool.
+		std::size_t pages_preallocated = {};
+	};
+
+	/*
+		Pool of initialized pages, allocated ahead of time so that taking one only moves its pointer.
+
+		The pool is refilled up to its target size either explicitly (see `refill`, e.g. during idle periods),
+		or by a background thread (see `start`), which is woken whenever a page is taken.
+		Pages are allocated and initialized without holding the pool's lock.
+	*/
+	template <typename PageType, typename PageType::value_type fill_value, bool initialize_pages>
+	class spare_page_pool
+	{
+		public:
+			using page_type = PageType;
+			using value_type = typename page_type::value_type;
+
+			using size_t = std::size_t;
+
+			// The value held by every element of a spare page.
+			inline static constexpr value_type page_value = ((initialize_pages) ? fill_value : value_type {});
+
+			spare_page_pool() = default;
+
+			~spare_page_pool()
+			{
+				stop();
+			}
+
+			spare_page_pool(const spare_page_pool&) = delete;
+			spare_page_pool& operator=(const spare_page_pool&) = delete;
+
+			// Takes a spare page, if one is immediately available. Never blocks.
+			std::optional<page_type> try_take()
+			{
+				auto pool_lock = std::unique_lock { pool_mutex, std::try_to_lock };
+
+				if ((!pool_lock.owns_lock()) || (spare_pages.empty()))
+				{
+					if (target_size.load(std::memory_order_relaxed) > 0)
+					{
+						misses.fetch_add(1, std::memory_order_relaxed);
+					}
+
+					return std::nullopt;
+				}
+
+				auto page = std::move(spare_pages.back());
+
+				spare_pages.pop_back();
+
+				pool_lock.unlock();
+
+				hits.fetch_add(1, std::memory_order_relaxed);
+
+				refill_requested.notify_one();
+
+				return page;
+			}
+
+			// Sets the number of spare pages to keep ready. Spare pages beyond the new target are released.
+			void set_target(size_t spare_page_count)
+			{
+				{
+					auto pool_lock = std::scoped_lock { pool_mutex };
+
+					target_size.store(spare_page_count, std::memory_order_relaxed);
+
+					if (spare_pages.size() > spare_page_count)
+					{
+						spare_pages.resize(spare_page_count);
+					}
+
+					spare_pages.reserve(spare_page_count);
+				}
+
+				refill_requested.notify_one();
+			}
+
+			size_t target() const
+			{
+				return target_size.load(std::memory_order_relaxed);
+			}
+
+			// Allocates pages until the pool reaches its target size, returning the number of pages added.
+			size_t refill()
+			{
+				auto pages_added = size_t {};
+
+				while (true)
+				{
+					{
+						auto pool_lock = std::scoped_lock { pool_mutex };
+
+						if (spare_pages.size() >= target_size.load(std::memory_order_relaxed))
+						{
+							break;
+						}
+					}
+
+					auto page = make_page();
+
+					pages_preallocated.fetch_add(1, std::memory_order_relaxed);
+
+					auto pool_lock = std::scoped_lock { pool_mutex };
+
+					// Another thread may have filled the pool in the meantime, in which case the page is simply discarded.
+					if (spare_pages.size() < target_size.load(std::memory_order_relaxed))
+					{
+						spare_pages.push_back(std::move(page));
+
+						pages_added++;
+					}
+				}
+
+				return pages_added;
+			}
+
+			// Starts a background thread which keeps the pool topped up. Has no effect if it's already running.
+			void start()
+			{
+				auto pool_lock = std::scoped_lock { pool_mutex };
+
+				if (worker.joinable())
+				{
+					return;
+				}
+
+				worker = std::jthread
+				{
+					[this](std::stop_token stop_token)
+					{
+						while (!stop_token.stop_requested())
+						{
+							refill();
+
+							auto wait_lock = std::unique_lock { pool_mutex };
+
+							refill_requested.wait
+							(
+								wait_lock, stop_token,
+
+								[this]()
+								{
+									return (spare_pages.size() < target_size.load(std::memory_order_relaxed));
+								}
+							);
+						}
+					}
+				};
+			}
+
+			// Stops the background thread (if any), waiting for it to exit.
+			void stop()
+			{
+				auto stopped_worker = std::jthread {};
+
+				{
+					auto pool_lock = std::scoped_lock { pool_mutex };
+
+					stopped_worker = std::move(worker);
+				}
+
+				// Destroying the thread requests a stop (waking it) and joins it.
+			}
+
+			// The number of spare pages currently available.
+			size_t size() const
+			{
+				auto pool_lock = std::scoped_lock { pool_mutex };
+
+				return spare_pages.size();
+			}
+
+			page_pool_stats get_stats() const
+			{
+				auto stats = page_pool_stats {};
+
+				stats.hits = hits.load(std::memory_order_relaxed);
+				stats.misses = misses.load(std::memory_order_relaxed);
+				stats.pages_preallocated = pages_preallocated.load(std::memory_order_relaxed);
+
+				return stats;
+			}
+
+		protected:
+			static page_type make_page()
+			{
+				if constexpr (initialize_pages)
+				{
+					return page_type { fill_value };
+				}
+				else
+				{
+					return page_type {};
+				}
+			}
+
+			std::vector<page_type> spare_pages;
+
+			std::atomic<size_t> target_size = { std::size_t {} };
+
+			std::atomic<size_t> hits = { std::size_t {} };
+			std::atomic<size_t> misses = { std::size_t {} };
+			std::atomic<size_t> pages_preallocated = { std::size_t {} };
+
+		private:
+			mutable std::mutex pool_mutex;
+
+			std::condition_variable_any refill_requested;
+
+			// Declared last, so that the thread is stopped before anything it uses is destroyed.
+			std::jthread worker;
+	};
+
 	template <typename T, typename BitOffsetType, typename AtomicType=std::atomic<T>, typename PointerType=AtomicType*>
 	class atomic_bit_reference
 	{
@@ -289,6 +742,66 @@ namespace immutableoctet
 	template <typename T, typename BitOffsetType, typename AtomicType=std::atomic<T>, typename PointerType=const AtomicType*>
 	using atomic_bit_const_reference = atomic_bit_reference<T, BitOffsetType, AtomicType, PointerType>;
 
+	// Bit reference which routes writes through its container, rather than directly to the underlying element.
+	template <typename ContainerType>
+	class container_bit_reference
+	{
+		public:
+			using container_type = ContainerType;
+			using index_t = typename container_type::index_t;
+			using value_type = bool;
+
+			container_bit_reference() :
+				container(nullptr),
+				index()
+			{}
+
+			container_bit_reference(container_type& container, index_t index) :
+				container(&container),
+				index(index)
+			{}
+
+			container_bit_reference(const container_bit_reference&) = default;
+			container_bit_reference(container_bit_reference&&) noexcept = default;
+
+			container_bit_reference& operator=(const container_bit_reference&) = default;
+			container_bit_reference& operator=(container_bit_reference&&) noexcept = default;
+
+			container_bit_reference& operator=(value_type value)
+			{
+				if (container)
+				{
+					container->set(index, value);
+				}
+
+				return *this;
+			}
+
+			value_type get() const
+			{
+				if (!container)
+				{
+					return {};
+				}
+
+				return container->get(index);
+			}
+
+			index_t get_index() const
+			{
+				return index;
+			}
+
+			operator value_type() const // explicit
+			{
+				return get();
+			}
+
+		protected:
+			container_type* container;
+			index_t index;
+	};
+
 	template
 	<
 		// Specifies the underlying integral type used to store binary data.
@@ -301,7 +814,17 @@ namespace immutableoctet
 		T default_element_value=T{},
 
 		// If enabled, initialization of pages will be performed using `default_element_value` for each element.
-		bool default_initialize=true
+		bool default_initialize=true,
+
+		// If enabled, writes mark their block of words as dirty, allowing changes to be exported with `collect_delta`.
+		// Note that this changes `reference` to `container_bit_reference` (see below).
+		bool track_dirty_blocks=false,
+
+		// If enabled, each page keeps a running count of its enabled bits, making `count` proportional to the number of pages.
+		bool track_population=false,
+
+		// If enabled, growth takes already-initialized pages from a pool of spares (see `set_spare_page_target`), when available.
+		bool preallocate_pages=false
 	>
 	class basic_atomic_bitset
 	{
@@ -321,6 +844,7 @@ namespace immutableoctet
 			using page_index_t = size_t;
 			using element_index_t = size_t;
 			using bit_index_t  = index_t;
+			using word_index_t = size_t;
 
 			using bit_location = std::tuple
 			<
@@ -329,9 +853,6 @@ namespace immutableoctet
 				bit_index_t      // The bitwise offset into the element where the value is stored.
 			>;
 
-			using reference       = atomic_bit_reference<T, bit_index_t>;
-			using const_reference = atomic_bit_const_reference<T, bit_index_t>;
-
 			inline static constexpr size_t page_size = static_cast<size_t>(fixed_page_size);
 
 			inline static constexpr size_t bits_per_byte = 8;
@@ -340,16 +861,83 @@ namespace immutableoctet
 
 			inline static constexpr bool is_atomic = true; // std::is_same_v<std::decay_t<element_type>, std::atomic<underlying_type>>;
 
-			template <bool is_const>
-			class iterator_impl
+			// Writes are observed by the bitset (see `on_word_updated`) if any form of change tracking is enabled.
+			inline static constexpr bool tracks_writes = (track_dirty_blocks || track_population);
+
+			/*
+				Mutable references must route writes through the bitset when they need to be observed.
+
+				Enabling `track_dirty_blocks` or `track_population` therefore changes `reference` from `atomic_bit_reference`
+				to `container_bit_reference`, which holds the bitset and an index rather than a word and bit offset.
+			*/
+			using reference = std::conditional_t
+			<
+				tracks_writes,
+
+				container_bit_reference<basic_atomic_bitset>,
+				atomic_bit_reference<T, bit_index_t>
+			>;
+
+			using const_reference = atomic_bit_const_reference<T, bit_index_t>;
+
+			// The number of words covered by each bit of the dirty map; one cache line's worth, where possible.
+			inline static constexpr size_t dirty_block_size = std::gcd(page_size, std::max((static_cast<size_t>(64) / sizeof(underlying_type)), static_cast<size_t>(1)));
+			inline static constexpr size_t dirty_blocks_per_page = (page_size / dirty_block_size);
+
+			// Each page's dirty map (one bit per block), padded so that writers to neighbouring pages don't share a line.
+			inline static constexpr size_t dirty_words_per_page = ((dirty_blocks_per_page + static_cast<size_t>(63)) / static_cast<size_t>(64));
+
+			using dirty_map_type = std::array<impl::padded_atomic<std::uint64_t>, dirty_words_per_page>;
+
+			// Each page's population is split across several counters (one per cache line), so that writers to different parts of a page don't contend.
+			inline static constexpr size_t population_shard_count = std::gcd(page_size, static_cast<size_t>(4));
+			inline static constexpr size_t elements_per_population_shard = (page_size / population_shard_count);
+
+			/*
+				Counters are signed: writers update them after their word, so concurrent updates to the same shard
+				can land out of order and briefly take it below zero (or past its capacity).
+			*/
+			using population_count_t = std::make_signed_t<size_t>;
+			using population_counter_type = std::array<impl::padded_atomic<population_count_t>, population_shard_count>;
+
+			using spare_page_pool_type = spare_page_pool<page_type, default_element_value, default_initialize>;
+
+			// The value held by each element of a spare page.
+			inline static constexpr underlying_type spare_page_value = spare_page_pool_type::page_value;
+
+			// The number of lookups ahead of the current one that `get_many` and `test_many` prefetch words for.
+			inline static constexpr size_t lookup_prefetch_distance = 8;
+
+			// The number of distinct words a `writer` buffers before flushing.
+			inline static constexpr size_t writer_cache_size = 8;
+
+			// A run of consecutive words from a single page, as exported by `collect_delta`.
+			struct delta_run
+			{
+				page_index_t page_index;
+				element_index_t element_index;
+
+				std::vector<underlying_type> words;
+			};
+
+			struct delta_type
+			{
+				// The size of the bitset at the time the delta was collected.
+				size_t size_in_bits = {};
+
+				std::vector<delta_run> runs;
+			};
+
+			template <bool is_const>
+			class iterator_impl
 			{
 				public:
 					using iterator_category = std::forward_iterator_tag;
 					using difference_type = index_t; // std::ptrdiff_t;
 					using value_type = bool;
 
-					using reference = atomic_bit_reference<T, bit_index_t>;
-					using const_reference = atomic_bit_const_reference<T, bit_index_t>;
+					using reference = typename basic_atomic_bitset::reference;
+					using const_reference = typename basic_atomic_bitset::const_reference;
 
 					//using pointer = reference*;
 
@@ -428,6 +1016,374 @@ namespace immutableoctet
 			using iterator = iterator_impl<false>;
 			using const_iterator = iterator_impl<true>;
 
+			/*
+				Grants non-atomic access to the bitset's words for single-threaded bulk phases (loading, rebuilding, etc.).
+
+				While a view exists, the caller guarantees that no other thread accesses the bitset; the view only holds
+				the resize mutex to keep the page list stable. Bits are updated with relaxed loads and stores rather than
+				read-modify-write operations, and `page_data` exposes each page as plain words for vectorizable loops.
+
+				Destroying the view issues a release fence and releases the resize mutex. Anything written through the
+				view is visible to threads which subsequently synchronize with the releasing thread (e.g. via thread creation,
+				the resize mutex, or their own acquire operations).
+			*/
+			class exclusive_view
+			{
+				public:
+					static_assert((sizeof(element_type) == sizeof(underlying_type)), "Atomic elements must share the layout of `underlying_type`");
+					static_assert((alignof(element_type) == alignof(underlying_type)), "Atomic elements must share the alignment of `underlying_type`");
+					static_assert((element_type::is_always_lock_free), "Atomic elements must be lock-free to be accessed as plain words");
+
+					explicit exclusive_view(basic_atomic_bitset& target_bitset) :
+						target_bitset(&target_bitset),
+						resize_lock(target_bitset.resize_mutex)
+					{}
+
+					exclusive_view(exclusive_view&&) noexcept = default;
+					exclusive_view& operator=(exclusive_view&&) noexcept = delete;
+
+					exclusive_view(const exclusive_view&) = delete;
+					exclusive_view& operator=(const exclusive_view&) = delete;
+
+					~exclusive_view()
+					{
+						if (!resize_lock.owns_lock())
+						{
+							return;
+						}
+
+						if constexpr (tracks_writes)
+						{
+							for (auto page_index = size_t {}; page_index < overwritten_pages.size(); page_index++)
+							{
+								if (overwritten_pages[page_index])
+								{
+									target_bitset->on_page_overwritten(static_cast<page_index_t>(page_index));
+								}
+							}
+						}
+
+						std::atomic_thread_fence(std::memory_order_release);
+					}
+
+					value_type get(index_t index) const
+					{
+						const auto* element = target_bitset->try_get_element(index);
+
+						if (!element)
+						{
+							return {};
+						}
+
+						const auto bitmask = make_bit_mask(resolve_bit_offset_from_index(index));
+
+						return ((element->load(std::memory_order_relaxed) & bitmask) != underlying_type {});
+					}
+
+					void set(index_t index, value_type value)
+					{
+						const auto bitmask = make_bit_mask(resolve_bit_offset_from_index(index));
+
+						auto& element = target_bitset->get_element(index);
+
+						const auto previous_value = element.load(std::memory_order_relaxed);
+
+						const auto updated_value = (value)
+							? static_cast<underlying_type>(previous_value | bitmask)
+							: static_cast<underlying_type>(previous_value & ~bitmask)
+						;
+
+						element.store(updated_value, std::memory_order_relaxed);
+
+						target_bitset->on_word_updated(resolve_word_index(index), previous_value, updated_value);
+					}
+
+					void enable(index_t index)
+					{
+						set(index, true);
+					}
+
+					void disable(index_t index)
+					{
+						set(index, false);
+					}
+
+					// Sets every bit in [`begin`, `end`) to `value`. Whole words are filled page-by-page as plain memory.
+					void fill(index_t begin, index_t end, value_type value)
+					{
+						if (begin >= end)
+						{
+							return;
+						}
+
+						const auto fill_value = (value)
+							? static_cast<underlying_type>(~underlying_type {})
+							: underlying_type {}
+						;
+
+						const auto first_word = resolve_word_index((begin + static_cast<index_t>(bit_stride - static_cast<size_t>(1))));
+						const auto last_word = resolve_word_index(end);
+
+						if (first_word >= last_word)
+						{
+							// No whole words are covered.
+							fill_partial(begin, end, value);
+
+							return;
+						}
+
+						fill_partial(begin, static_cast<index_t>(first_word * bit_stride), value);
+
+						for (auto word_index = first_word; word_index < last_word; )
+						{
+							const auto page_index = static_cast<page_index_t>(word_index / page_size);
+							const auto element_index = static_cast<size_t>(word_index % page_size);
+							const auto word_count = std::min((page_size - element_index), static_cast<size_t>(last_word - word_index));
+
+							auto* words = page_data(page_index);
+
+							assert(words);
+
+							std::fill_n((words + element_index), word_count, fill_value);
+
+							word_index += static_cast<word_index_t>(word_count);
+						}
+
+						fill_partial(static_cast<index_t>(last_word * bit_stride), end, value);
+					}
+
+					/*
+						Returns the words of the specified page as plain (non-atomic) integers, or null if the page isn't allocated.
+
+						Change tracking can't observe writes made this way, so the page is treated as
+						having been entirely overwritten once the view is destroyed.
+					*/
+					underlying_type* page_data(page_index_t page_index)
+					{
+						auto* elements = target_bitset->get_page_data(page_index);
+
+						if (!elements)
+						{
+							return {};
+						}
+
+						if constexpr (tracks_writes)
+						{
+							const auto native_page_index = static_cast<std::size_t>(page_index);
+
+							if (native_page_index >= overwritten_pages.size())
+							{
+								overwritten_pages.resize((native_page_index + static_cast<std::size_t>(1)));
+							}
+
+							overwritten_pages[native_page_index] = true;
+						}
+
+						// Atomic elements are layout-compatible with `underlying_type` here (see above),
+						// the same assumption that backs `std::atomic_ref`.
+						return reinterpret_cast<underlying_type*>(elements);
+					}
+
+					const underlying_type* page_data(page_index_t page_index) const
+					{
+						const auto* elements = static_cast<const basic_atomic_bitset*>(target_bitset)->get_page_data(page_index);
+
+						return reinterpret_cast<const underlying_type*>(elements);
+					}
+
+					size_t page_count() const
+					{
+						return target_bitset->pages_allocated();
+					}
+
+					size_t size() const
+					{
+						return target_bitset->size();
+					}
+
+					size_t resize(size_t requested_size)
+					{
+						return target_bitset->resize(requested_size);
+					}
+
+					size_t reserve(size_t requested_size)
+					{
+						return target_bitset->reserve(requested_size);
+					}
+
+				protected:
+					void fill_partial(index_t begin, index_t end, value_type value)
+					{
+						for_each_word_mask
+						(
+							begin, end,
+
+							[this, value](word_index_t word_index, underlying_type mask)
+							{
+								auto& element = target_bitset->get_word(word_index);
+
+								const auto previous_value = element.load(std::memory_order_relaxed);
+
+								const auto updated_value = (value)
+									? static_cast<underlying_type>(previous_value | mask)
+									: static_cast<underlying_type>(previous_value & ~mask)
+								;
+
+								element.store(updated_value, std::memory_order_relaxed);
+
+								target_bitset->on_word_updated(word_index, previous_value, updated_value);
+
+								return true;
+							}
+						);
+					}
+
+					basic_atomic_bitset* target_bitset;
+
+					std::unique_lock<std::recursive_mutex> resize_lock;
+
+					[[no_unique_address]] std::conditional_t<tracks_writes, std::vector<bool>, impl::disabled_feature> overwritten_pages;
+			};
+
+			/*
+				Write-combining handle, intended to be owned by a single thread (e.g. as a local or `thread_local`).
+
+				Writes made through a writer are buffered as per-word set/reset masks in a cache of `writer_cache_size` words.
+				Each buffered word is applied with a single `fetch_or_mask` and/or `fetch_and_mask` when the cache is full
+				and a new word is written, on `flush`, or when the writer is destroyed. Writes which cluster in a few words
+				therefore cost one atomic operation per word rather than one per bit.
+
+				Buffered writes aren't visible to anyone (including reads through the bitset on the writer's own thread)
+				until they're flushed. Once `flush` returns, each word's writes are visible just as if they'd been made with
+				`enable`/`disable` at that point; writes to different words are applied one at a time, not as a single atomic unit.
+				Change tracking (see `on_word_updated`) observes writes when they're flushed.
+
+				Indices must lie within the bitset's allocated storage (see `reserve`) by the time they're flushed.
+			*/
+			class writer
+			{
+				public:
+					explicit writer(basic_atomic_bitset& target_bitset) :
+						target_bitset(&target_bitset)
+					{}
+
+					writer(writer&& other) noexcept :
+						target_bitset(other.target_bitset),
+						entries(other.entries),
+						entry_count(std::exchange(other.entry_count, size_t {}))
+					{}
+
+					writer& operator=(writer&&) = delete;
+
+					writer(const writer&) = delete;
+					writer& operator=(const writer&) = delete;
+
+					~writer()
+					{
+						flush();
+					}
+
+					void enable(index_t index)
+					{
+						const auto bitmask = make_bit_mask(resolve_bit_offset_from_index(index));
+
+						auto& entry = get_entry(resolve_word_index(index));
+
+						entry.set_mask |= bitmask;
+						entry.reset_mask &= static_cast<underlying_type>(~bitmask);
+					}
+
+					void disable(index_t index)
+					{
+						const auto bitmask = make_bit_mask(resolve_bit_offset_from_index(index));
+
+						auto& entry = get_entry(resolve_word_index(index));
+
+						entry.reset_mask |= bitmask;
+						entry.set_mask &= static_cast<underlying_type>(~bitmask);
+					}
+
+					void set(index_t index, value_type value)
+					{
+						if (value)
+						{
+							enable(index);
+						}
+						else
+						{
+							disable(index);
+						}
+					}
+
+					// Applies every buffered write to the bitset, returning the number of words written.
+					size_t flush()
+					{
+						const auto flushed_words = entry_count;
+
+						for (auto entry_index = size_t {}; entry_index < entry_count; entry_index++)
+						{
+							const auto& entry = entries[entry_index];
+
+							if (entry.set_mask != underlying_type {})
+							{
+								target_bitset->fetch_or_mask(entry.word_index, entry.set_mask);
+							}
+
+							if (entry.reset_mask != underlying_type {})
+							{
+								target_bitset->fetch_and_mask(entry.word_index, static_cast<underlying_type>(~entry.reset_mask));
+							}
+						}
+
+						entry_count = {};
+
+						return flushed_words;
+					}
+
+					// The number of words with writes waiting to be flushed.
+					size_t pending_words() const
+					{
+						return entry_count;
+					}
+
+				protected:
+					struct entry_type
+					{
+						word_index_t word_index;
+
+						// Bits to enable and disable, respectively; never overlapping.
+						underlying_type set_mask;
+						underlying_type reset_mask;
+					};
+
+					entry_type& get_entry(word_index_t word_index)
+					{
+						for (auto entry_index = size_t {}; entry_index < entry_count; entry_index++)
+						{
+							if (entries[entry_index].word_index == word_index)
+							{
+								return entries[entry_index];
+							}
+						}
+
+						if (entry_count == entries.size())
+						{
+							flush();
+						}
+
+						auto& entry = entries[entry_count++];
+
+						entry = entry_type { word_index, underlying_type {}, underlying_type {} };
+
+						return entry;
+					}
+
+					basic_atomic_bitset* target_bitset;
+
+					std::array<entry_type, writer_cache_size> entries = {};
+					size_t entry_count = {};
+			};
+
 			static constexpr page_index_t resolve_page_index(index_t index)
 			{
 				return (static_cast<page_index_t>(index) / static_cast<page_index_t>(page_stride));
@@ -443,6 +1399,11 @@ namespace immutableoctet
 				return static_cast<bit_index_t>(index % static_cast<index_t>(bit_stride));
 			}
 
+			static constexpr word_index_t resolve_word_index(index_t index)
+			{
+				return (static_cast<word_index_t>(index) / static_cast<word_index_t>(bit_stride));
+			}
+
 			static constexpr bit_location resolve_index(index_t index)
 			{
 				const auto page_index = resolve_page_index(index);
@@ -525,6 +1486,51 @@ namespace immutableoctet
 				return (*element);
 			}
 
+			// Retrieves an element using its overall position in the bitset, rather than a bit index.
+			element_type* try_get_word(word_index_t word_index)
+			{
+				const auto page_index = static_cast<page_index_t>(word_index / static_cast<word_index_t>(page_size));
+				auto* page_data = get_page_data(page_index);
+
+				if (!page_data)
+				{
+					return {};
+				}
+
+				return &page_data[static_cast<element_index_t>(word_index % static_cast<word_index_t>(page_size))];
+			}
+
+			const element_type* try_get_word(word_index_t word_index) const
+			{
+				const auto page_index = static_cast<page_index_t>(word_index / static_cast<word_index_t>(page_size));
+				const auto* page_data = get_page_data(page_index);
+
+				if (!page_data)
+				{
+					return {};
+				}
+
+				return &page_data[static_cast<element_index_t>(word_index % static_cast<word_index_t>(page_size))];
+			}
+
+			element_type& get_word(word_index_t word_index)
+			{
+				auto* element = try_get_word(word_index);
+
+				assert(element);
+
+				return (*element);
+			}
+
+			const element_type& get_word(word_index_t word_index) const
+			{
+				const auto* element = try_get_word(word_index);
+
+				assert(element);
+
+				return (*element);
+			}
+
 			reference get_reference(index_t index)
 			{
 				auto* element = try_get_element(index);
@@ -534,9 +1540,16 @@ namespace immutableoctet
 					return {};
 				}
 
-				const auto bit_offset = resolve_bit_offset_from_index(index);
+				if constexpr (tracks_writes)
+				{
+					return reference { *this, index };
+				}
+				else
+				{
+					const auto bit_offset = resolve_bit_offset_from_index(index);
 
-				return reference { *element, bit_offset };
+					return reference { *element, bit_offset };
+				}
 			}
 
 			const_reference get_reference(index_t index) const
@@ -567,13 +1580,63 @@ namespace immutableoctet
 				return impl::get_bit(*element, bit_offset);
 			}
 
-			underlying_type set(index_t index, value_type value)
+			/*
+				Looks up each of `indices`, writing `get(indices[i])` to `out[i]`.
+
+				Lookups are pipelined: the page entry for each index is prefetched `2 * lookup_prefetch_distance` lookups ahead,
+				and its word `lookup_prefetch_distance` lookups ahead, so that cache misses on random indices overlap.
+				Indices beyond the allocated pages read as false.
+			*/
+			void get_many(std::span<const index_t> indices, std::span<value_type> out) const
 			{
-				const auto bit_offset = resolve_bit_offset_from_index(index);
+				assert(out.size() >= indices.size());
 
-				auto& element = get_element(index);
+				probe_many
+				(
+					indices,
+
+					[out](size_t lookup_index, value_type value)
+					{
+						out[lookup_index] = value;
+					}
+				);
+			}
+
+			/*
+				Looks up each of `indices` as `get_many` does, but packs the results into a bitmask:
+				bit `i % bit_stride` of `out[i / bit_stride]` is set to `get(indices[i])`.
 
-				return impl::set_bit(element, bit_offset, value);
+				Returns the number of indices found to be set.
+			*/
+			size_t test_many(std::span<const index_t> indices, std::span<underlying_type> out) const
+			{
+				assert((out.size() * bit_stride) >= indices.size());
+
+				auto result = size_t {};
+
+				std::fill(out.begin(), (out.begin() + static_cast<std::ptrdiff_t>((indices.size() + (bit_stride - static_cast<size_t>(1))) / bit_stride)), underlying_type {});
+
+				probe_many
+				(
+					indices,
+
+					[out, &result](size_t lookup_index, value_type value)
+					{
+						out[(lookup_index / bit_stride)] |= static_cast<underlying_type>(static_cast<underlying_type>(value) << (lookup_index % bit_stride));
+
+						result += static_cast<size_t>(value);
+					}
+				);
+
+				return result;
+			}
+
+			underlying_type set(index_t index, value_type value)
+			{
+				return (value)
+					? enable(index)
+					: disable(index)
+				;
 			}
 
 			underlying_type enable(index_t index)
@@ -582,7 +1645,11 @@ namespace immutableoctet
 
 				auto& element = get_element(index);
 
-				return impl::enable_bit(element, bit_offset);
+				const auto previous_value = impl::enable_bit(element, bit_offset);
+
+				on_word_updated(resolve_word_index(index), previous_value, static_cast<underlying_type>(previous_value | make_bit_mask(bit_offset)));
+
+				return previous_value;
 			}
 
 			underlying_type disable(index_t index)
@@ -591,7 +1658,11 @@ namespace immutableoctet
 
 				auto& element = get_element(index);
 
-				return impl::disable_bit(element, bit_offset);
+				const auto previous_value = impl::disable_bit(element, bit_offset);
+
+				on_word_updated(resolve_word_index(index), previous_value, static_cast<underlying_type>(previous_value & ~make_bit_mask(bit_offset)));
+
+				return previous_value;
 			}
 
 			underlying_type toggle(index_t index)
@@ -600,7 +1671,205 @@ namespace immutableoctet
 
 				auto& element = get_element(index);
 
-				return impl::toggle_bit(element, bit_offset);
+				const auto previous_value = impl::toggle_bit(element, bit_offset);
+
+				on_word_updated(resolve_word_index(index), previous_value, static_cast<underlying_type>(previous_value ^ make_bit_mask(bit_offset)));
+
+				return previous_value;
+			}
+
+			// Atomically enables every bit of `mask` in the specified word, returning the word's previous value.
+			underlying_type fetch_or_mask(word_index_t word_index, underlying_type mask)
+			{
+				auto& element = get_word(word_index);
+
+				const auto previous_value = element.fetch_or(mask);
+
+				on_word_updated(word_index, previous_value, static_cast<underlying_type>(previous_value | mask));
+
+				return previous_value;
+			}
+
+			// Atomically clears every bit not present in `mask`, returning the word's previous value.
+			underlying_type fetch_and_mask(word_index_t word_index, underlying_type mask)
+			{
+				auto& element = get_word(word_index);
+
+				const auto previous_value = element.fetch_and(mask);
+
+				on_word_updated(word_index, previous_value, static_cast<underlying_type>(previous_value & mask));
+
+				return previous_value;
+			}
+
+			// Atomically enables every bit of `mask`, but only if all of those bits are currently disabled.
+			bool compare_and_set_mask(word_index_t word_index, underlying_type mask)
+			{
+				auto& element = get_word(word_index);
+
+				if (!impl::compare_and_set_mask(element, mask))
+				{
+					return false;
+				}
+
+				// Only the bits of `mask` changed, so they're all we need to report.
+				on_word_updated(word_index, underlying_type {}, mask);
+
+				return true;
+			}
+
+			/*
+				Finds and claims (enables) `length` contiguous disabled bits, returning the index of the first bit claimed.
+
+				Each word covered by the run is claimed atomically via `compare_and_set_mask`.
+				Runs spanning several words are claimed one word at a time; if a later word
+				is lost to another thread, every word claimed so far is rolled back and the search resumes.
+			*/
+			std::optional<index_t> try_acquire_run(size_t length)
+			{
+				const auto bits_available = size();
+
+				if ((length == 0) || (length > bits_available))
+				{
+					return std::nullopt;
+				}
+
+				auto run_start = find_next_in_range(index_t {}, bits_available, false);
+
+				while ((run_start + length) <= bits_available)
+				{
+					const auto run_end = (run_start + length);
+					const auto conflict = find_next_in_range(run_start, run_end, true);
+
+					if (conflict != run_end)
+					{
+						run_start = find_next_in_range((conflict + static_cast<index_t>(1)), bits_available, false);
+
+						continue;
+					}
+
+					const auto claimed_end = for_each_word_mask
+					(
+						run_start, run_end,
+
+						[this](word_index_t word_index, underlying_type mask)
+						{
+							return compare_and_set_mask(word_index, mask);
+						}
+					);
+
+					if (claimed_end == run_end)
+					{
+						return run_start;
+					}
+
+					// Roll back the words we managed to claim before the conflict, then rescan from the same position.
+					release_bits(run_start, claimed_end);
+				}
+
+				return std::nullopt;
+			}
+
+			// Disables `length` bits starting at `index`; the counterpart to `try_acquire_run`.
+			void release_run(index_t index, size_t length)
+			{
+				release_bits(index, (index + static_cast<index_t>(length)));
+			}
+
+			/*
+				Exports every block of words written since the previous call, clearing the dirty map as it goes.
+
+				Each dirty bit is atomically exchanged before its words are read, so a write racing with
+				collection is either included in this delta or marked again for the next one.
+				Applying deltas in the order they were collected converges a replica on the source's state.
+			*/
+			delta_type collect_delta()
+			{
+				static_assert(track_dirty_blocks, "Dirty tracking must be enabled to collect deltas");
+
+				auto delta = delta_type {};
+
+				delta.size_in_bits = size();
+
+				const auto page_count = static_cast<page_index_t>(pages_allocated());
+
+				for (auto page_index = page_index_t {}; page_index < page_count; page_index++)
+				{
+					const auto* page_data = get_page_data(page_index);
+					auto& page_dirty_map = dirty_blocks[static_cast<size_t>(page_index)];
+
+					for (auto dirty_word_index = size_t {}; dirty_word_index < dirty_words_per_page; dirty_word_index++)
+					{
+						auto& dirty_word_slot = page_dirty_map[dirty_word_index];
+
+						if (dirty_word_slot.load(std::memory_order_relaxed) == std::uint64_t {})
+						{
+							continue;
+						}
+
+						auto dirty_word = dirty_word_slot.exchange(std::uint64_t {});
+
+						while (dirty_word)
+						{
+							const auto block_index = static_cast<size_t>
+							(
+								(dirty_word_index * static_cast<size_t>(64))
+								+
+								static_cast<size_t>(std::countr_zero(dirty_word))
+							);
+
+							dirty_word &= (dirty_word - static_cast<std::uint64_t>(1));
+
+							const auto element_index = static_cast<element_index_t>(block_index * dirty_block_size);
+
+							const auto extends_last_run =
+							(
+								(!delta.runs.empty())
+								&&
+								(delta.runs.back().page_index == page_index)
+								&&
+								((delta.runs.back().element_index + delta.runs.back().words.size()) == element_index)
+							);
+
+							if (!extends_last_run)
+							{
+								delta.runs.push_back(delta_run { page_index, element_index, {} });
+							}
+
+							auto& run_words = delta.runs.back().words;
+
+							for (auto word_offset = size_t {}; word_offset < dirty_block_size; word_offset++)
+							{
+								run_words.push_back(page_data[(element_index + word_offset)].load());
+							}
+						}
+					}
+				}
+
+				return delta;
+			}
+
+			// Applies a delta produced by another bitset's `collect_delta`, resizing to match the source.
+			void apply_delta(const delta_type& delta)
+			{
+				resize(delta.size_in_bits);
+
+				for (const auto& run : delta.runs)
+				{
+					allocate_pages_up_to(run.page_index);
+
+					const auto first_word_index = static_cast<word_index_t>((run.page_index * page_size) + run.element_index);
+
+					for (auto word_offset = size_t {}; word_offset < run.words.size(); word_offset++)
+					{
+						const auto word_index = (first_word_index + static_cast<word_index_t>(word_offset));
+						const auto updated_value = run.words[word_offset];
+
+						const auto previous_value = get_word(word_index).exchange(updated_value);
+
+						on_word_updated(word_index, previous_value, updated_value);
+					}
+				}
 			}
 
 			underlying_type speculative_set(index_t index, value_type value)
@@ -673,79 +1942,322 @@ namespace immutableoctet
 				return emplace_back(value);
 			}
 
-			value_type pop_back()
+			value_type pop_back()
+			{
+				//auto resize_lock = std::scoped_lock { resize_mutex };
+
+				if (empty())
+				{
+					return {};
+				}
+
+				const auto updated_size = (size_in_bits - static_cast<size_t>(1));
+
+				const auto value = get(updated_size);
+
+				size_in_bits = updated_size;
+
+				return value;
+			}
+
+			index_t next_index() const
+			{
+				return static_cast<index_t>(size());
+			}
+
+			index_t last_index() const
+			{
+				if (empty())
+				{
+					return {};
+				}
+
+				return (next_index() - static_cast<index_t>(1));
+			}
+
+			size_t page_count() const
+			{
+				if (size() <= static_cast<size_t>(page_stride))
+				{
+					return 1;
+				}
+
+				return static_cast<size_t>(size() / static_cast<size_t>(page_stride));
+			}
+
+			size_t element_count() const
+			{
+				if (size() <= static_cast<size_t>(bit_stride))
+				{
+					return 1;
+				}
+
+				return
+				(
+					(static_cast<size_t>(size() / static_cast<size_t>(bit_stride)))
+					+
+					static_cast<size_t>((size() % static_cast<size_t>(bit_stride)) > 0)
+				);
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			size_t size() const
+			{
+				//return (element_count() * static_cast<size_t>(bit_stride));
+
+				return size_in_bits;
+			}
+
+			size_t capacity() const
+			{
+				return bits_allocated();
+			}
+
+			/*
+				The number of enabled bits in [0, `size()`).
+
+				With `track_population` enabled, this reads each page's counters rather than its contents,
+				scanning only the part of the final page which is either in use or beyond `size()` (whichever is smaller).
+				The result isn't a snapshot; writes made while counting may or may not be reflected.
+			*/
+			size_t count() const
+			{
+				const auto bits_in_use = size();
+
+				if constexpr (track_population)
+				{
+					const auto full_page_count = static_cast<size_t>(bits_in_use / page_stride);
+					const auto remaining_bits = static_cast<size_t>(bits_in_use % page_stride);
+
+					auto result = size_t {};
+
+					for (auto page_index = size_t {}; page_index < full_page_count; page_index++)
+					{
+						result += page_population(static_cast<page_index_t>(page_index));
+					}
+
+					if (remaining_bits > 0)
+					{
+						const auto page_begin = static_cast<index_t>(full_page_count * page_stride);
+
+						if (remaining_bits <= (page_stride / 2))
+						{
+							result += count_range(page_begin, static_cast<index_t>(bits_in_use));
+						}
+						else
+						{
+							const auto page_total = page_population(static_cast<page_index_t>(full_page_count));
+							const auto bits_past_end = count_range(static_cast<index_t>(bits_in_use), static_cast<index_t>(page_begin + page_stride));
+
+							result += ((page_total > bits_past_end) ? (page_total - bits_past_end) : size_t {});
+						}
+					}
+
+					return result;
+				}
+				else
+				{
+					return count_range(index_t {}, static_cast<index_t>(bits_in_use));
+				}
+			}
+
+			// The number of enabled bits held by `page_index`, including any beyond `size()`.
+			size_t page_population(page_index_t page_index) const
+			{
+				if (page_index >= pages_allocated())
+				{
+					return {};
+				}
+
+				if constexpr (track_population)
+				{
+					const auto& shards = page_populations[static_cast<size_t>(page_index)];
+
+					auto result = population_count_t {};
+
+					for (const auto& shard : shards)
+					{
+						result += shard.load(std::memory_order_relaxed);
+					}
+
+					// Out-of-order updates may briefly put the total outside of what the page can hold.
+					return static_cast<size_t>(std::clamp(result, population_count_t {}, static_cast<population_count_t>(page_stride)));
+				}
+				else
+				{
+					const auto page_begin = static_cast<index_t>(page_index * page_stride);
+
+					return count_range(page_begin, static_cast<index_t>(page_begin + page_stride));
+				}
+			}
+
+			/*
+				Writes the indices of enabled bits in [`begin`, `end`) to `out`, in ascending order, returning the number written.
+
+				Stops early once `out` is full; the remaining indices can be retrieved by calling again
+				with `begin` set to one past the last index written. Entries of `out` beyond the returned count may be overwritten.
+			*/
+			size_t to_indices_range(std::span<index_t> out, index_t begin, index_t end) const
+			{
+				auto written = size_t {};
+
+				end = std::min(end, static_cast<index_t>(size()));
+
+				for_each_word_mask
+				(
+					begin, end,
+
+					[this, out, &written](word_index_t word_index, underlying_type mask)
+					{
+						auto word = static_cast<underlying_type>(get_word(word_index).load(std::memory_order_relaxed) & mask);
+
+						const auto base = static_cast<index_t>(word_index * static_cast<word_index_t>(bit_stride));
+
+						if ((out.size() - written) >= bit_stride)
+						{
+							written += impl::expand_word_indices(word, base, (out.data() + written));
+
+							return true;
+						}
+
+						// Too close to the end of `out` to expand the whole word at once.
+						while ((word != underlying_type {}) && (written < out.size()))
+						{
+							out[written++] = static_cast<index_t>(base + static_cast<index_t>(std::countr_zero(word)));
+
+							word &= static_cast<underlying_type>(word - static_cast<underlying_type>(1));
+						}
+
+						return (word == underlying_type {});
+					}
+				);
+
+				return written;
+			}
+
+			// Writes the indices of enabled bits from `offset` onward to `out`; see `to_indices_range`.
+			size_t to_indices(std::span<index_t> out, index_t offset={}) const
+			{
+				return to_indices_range(out, offset, static_cast<index_t>(size()));
+			}
+
+			/*
+				Exports the indices of enabled bits in [`begin`, `end`) in batches, using `buffer` as scratch space.
+				Executes `callback(indices)` with a `std::span<const index_t>` for each filled batch.
+
+				Returns the total number of indices exported.
+			*/
+			template <typename Callback>
+			size_t for_each_index_batch(std::span<index_t> buffer, index_t begin, index_t end, Callback&& callback) const
 			{
-				//auto resize_lock = std::scoped_lock { resize_mutex };
+				assert(!buffer.empty());
 
-				if (empty())
+				auto total = size_t {};
+
+				while (begin < end)
 				{
-					return {};
-				}
+					const auto written = to_indices_range(buffer, begin, end);
 
-				const auto updated_size = (size_in_bits - static_cast<size_t>(1));
+					if (written == 0)
+					{
+						break;
+					}
 
-				const auto value = get(updated_size);
+					// Read before the callback, in case it reuses the buffer.
+					const auto next_begin = static_cast<index_t>(buffer[(written - static_cast<size_t>(1))] + static_cast<index_t>(1));
 
-				size_in_bits = updated_size;
+					callback(std::span<const index_t> { buffer.data(), written });
 
-				return value;
+					total += written;
+
+					if (written < buffer.size())
+					{
+						break;
+					}
+
+					begin = next_begin;
+				}
+
+				return total;
 			}
 
-			index_t next_index() const
+			template <typename Callback>
+			size_t for_each_index_batch(std::span<index_t> buffer, Callback&& callback) const
 			{
-				return static_cast<index_t>(size());
+				return for_each_index_batch(buffer, index_t {}, static_cast<index_t>(size()), std::forward<Callback>(callback));
 			}
 
-			index_t last_index() const
+			/*
+				Sets the number of initialized spare pages kept ready for growth.
+				
+				The pool is topped up by `refill_spare_pages` or by a background thread (see `start_page_preallocator`).
+				While spares are available, growing the bitset by a page moves the spare into the page vector, rather than
+				allocating and initializing one. This and `refill_spare_pages` also reserve room in the page vector for
+				the spares, so that moving them in doesn't reallocate it; pages taken after that room runs out
+				(e.g. while only the background thread is refilling the pool) may still reallocate it.
+			*/
+			void set_spare_page_target(size_t spare_page_count)
 			{
-				if (empty())
-				{
-					return {};
-				}
+				static_assert(preallocate_pages, "Page preallocation must be enabled to keep spare pages");
 
-				return (next_index() - static_cast<index_t>(1));
+				spare_pages.set_target(spare_page_count);
+
+				reserve_spare_page_entries();
 			}
 
-			size_t page_count() const
+			// Allocates spare pages up to the configured target (e.g. during idle periods). Returns the number of pages added.
+			size_t refill_spare_pages()
 			{
-				if (size() <= static_cast<size_t>(page_stride))
-				{
-					return 1;
-				}
+				static_assert(preallocate_pages, "Page preallocation must be enabled to keep spare pages");
 
-				return static_cast<size_t>(size() / static_cast<size_t>(page_stride));
+				reserve_spare_page_entries();
+
+				return spare_pages.refill();
 			}
 
-			size_t element_count() const
+			// Starts a background thread which refills the spare page pool whenever a page is taken from it.
+			void start_page_preallocator()
 			{
-				if (size() <= static_cast<size_t>(bit_stride))
-				{
-					return 1;
-				}
+				static_assert(preallocate_pages, "Page preallocation must be enabled to keep spare pages");
 
-				return
-				(
-					(static_cast<size_t>(size() / static_cast<size_t>(bit_stride)))
-					+
-					static_cast<size_t>((size() % static_cast<size_t>(bit_stride)) > 0)
-				);
+				spare_pages.start();
 			}
 
-			bool empty() const
+			void stop_page_preallocator()
 			{
-				return (size() == 0);
+				static_assert(preallocate_pages, "Page preallocation must be enabled to keep spare pages");
+
+				spare_pages.stop();
 			}
 
-			size_t size() const
+			// The number of spare pages currently ready.
+			size_t spare_page_count() const
 			{
-				//return (element_count() * static_cast<size_t>(bit_stride));
-
-				return size_in_bits;
+				if constexpr (preallocate_pages)
+				{
+					return spare_pages.size();
+				}
+				else
+				{
+					return {};
+				}
 			}
 
-			size_t capacity() const
+			// Reports how often growth was served from the spare page pool, and how often the pool had run dry.
+			page_pool_stats get_page_pool_stats() const
 			{
-				return bits_allocated();
+				if constexpr (preallocate_pages)
+				{
+					return spare_pages.get_stats();
+				}
+				else
+				{
+					return {};
+				}
 			}
 
 			size_t reserve(size_t requested_size)
@@ -797,7 +2309,11 @@ namespace immutableoctet
 
 					allocate_pages_for_index(requested_index);
 
-					size_in_bits = (index_as_size + static_cast<size_t>(1));
+					// Another thread may have requested a larger index while this one waited for the lock; never shrink.
+					if (index_as_size >= size())
+					{
+						size_in_bits = (index_as_size + static_cast<size_t>(1));
+					}
 				}
 
 				return size();
@@ -810,6 +2326,18 @@ namespace immutableoctet
 				size_in_bits = 0;
 			}
 
+			// Begins a single-threaded bulk phase; see `exclusive_view`.
+			exclusive_view lock_for_bulk()
+			{
+				return exclusive_view { *this };
+			}
+
+			// Creates a write-combining handle for the calling thread; see `writer`.
+			writer make_writer()
+			{
+				return writer { *this };
+			}
+
 			const_iterator cbegin() const
 			{
 				return const_iterator { *this, index_t {} };
@@ -870,6 +2398,156 @@ namespace immutableoctet
 			}
 
 		protected:
+			static constexpr underlying_type make_bit_mask(bit_index_t bit_offset)
+			{
+				return static_cast<underlying_type>(static_cast<underlying_type>(1) << static_cast<underlying_type>(bit_offset));
+			}
+
+			// Invoked after every write made through the bitset's interface, with the word's value before and after the write.
+			void on_word_updated(word_index_t word_index, underlying_type previous_value, underlying_type updated_value)
+			{
+				if constexpr (track_dirty_blocks)
+				{
+					if (previous_value != updated_value)
+					{
+						mark_dirty_block(word_index);
+					}
+				}
+
+				if constexpr (track_population)
+				{
+					const auto previous_population = static_cast<population_count_t>(std::popcount(previous_value));
+					const auto updated_population = static_cast<population_count_t>(std::popcount(updated_value));
+
+					// Only writes which actually changed a bit touch the counters.
+					if (previous_population != updated_population)
+					{
+						get_population_shard(word_index).fetch_add((updated_population - previous_population), std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// Invoked when a page's words may have been rewritten without going through `on_word_updated`.
+			void on_page_overwritten(page_index_t page_index)
+			{
+				if constexpr (track_dirty_blocks)
+				{
+					const auto first_word_index = static_cast<word_index_t>(page_index * page_size);
+
+					for (auto block_index = size_t {}; block_index < dirty_blocks_per_page; block_index++)
+					{
+						mark_dirty_block(static_cast<word_index_t>(first_word_index + static_cast<word_index_t>(block_index * dirty_block_size)));
+					}
+				}
+
+				if constexpr (track_population)
+				{
+					recount_page_population(page_index);
+				}
+			}
+
+			void mark_dirty_block(word_index_t word_index)
+			{
+				const auto page_index = static_cast<size_t>(word_index / static_cast<word_index_t>(page_size));
+				const auto block_index = static_cast<size_t>((word_index % static_cast<word_index_t>(page_size)) / static_cast<word_index_t>(dirty_block_size));
+
+				auto& dirty_word = dirty_blocks[page_index][(block_index / static_cast<size_t>(64))];
+
+				const auto block_mask = (static_cast<std::uint64_t>(1) << (block_index % static_cast<size_t>(64)));
+
+				// Avoid contending on the dirty map when the block's already been marked.
+				if ((dirty_word.load(std::memory_order_relaxed) & block_mask) == std::uint64_t {})
+				{
+					dirty_word.fetch_or(block_mask);
+				}
+			}
+
+			impl::padded_atomic<population_count_t>& get_population_shard(word_index_t word_index)
+			{
+				const auto page_index = static_cast<size_t>(word_index / static_cast<word_index_t>(page_size));
+				const auto element_index = static_cast<size_t>(word_index % static_cast<word_index_t>(page_size));
+
+				return page_populations[page_index][(element_index / elements_per_population_shard)];
+			}
+
+			// Recomputes the population counters of `page_index` from its contents.
+			void recount_page_population(page_index_t page_index)
+			{
+				const auto* elements = static_cast<const basic_atomic_bitset*>(this)->get_page_data(page_index);
+
+				if (!elements)
+				{
+					return;
+				}
+
+				auto& shards = page_populations[static_cast<size_t>(page_index)];
+
+				for (auto shard_index = size_t {}; shard_index < population_shard_count; shard_index++)
+				{
+					const auto first_element = (shard_index * elements_per_population_shard);
+
+					auto population = population_count_t {};
+
+					for (auto element_index = first_element; element_index < (first_element + elements_per_population_shard); element_index++)
+					{
+						population += static_cast<population_count_t>(std::popcount(elements[element_index].load(std::memory_order_relaxed)));
+					}
+
+					shards[shard_index].store(population, std::memory_order_relaxed);
+				}
+			}
+
+			/*
+				Prepares population counters for pages [`pages_allocated()`, `page_count`), starting each at the population
+				of a page filled with `element_value`. Must be called before those pages are published.
+			*/
+			void reserve_population_counters(size_t page_count, underlying_type element_value)
+			{
+				if constexpr (track_population)
+				{
+					const auto shard_population = static_cast<population_count_t>(static_cast<size_t>(std::popcount(element_value)) * elements_per_population_shard);
+
+					page_populations.reserve(page_count);
+
+					for (auto page_index = pages_allocated(); page_index < page_count; page_index++)
+					{
+						for (auto& shard : page_populations[page_index])
+						{
+							shard.store(shard_population, std::memory_order_relaxed);
+						}
+					}
+				}
+			}
+
+			// Counts the enabled bits in [`begin`, `end`) by scanning their words.
+			size_t count_range(index_t begin, index_t end) const
+			{
+				auto result = size_t {};
+
+				for_each_word_mask
+				(
+					begin, end,
+
+					[this, &result](word_index_t word_index, underlying_type mask)
+					{
+						result += static_cast<size_t>(std::popcount(static_cast<underlying_type>(get_word(word_index).load(std::memory_order_relaxed) & mask)));
+
+						return true;
+					}
+				);
+
+				return result;
+			}
+
+			// Ensures the dirty maps of the first `page_count` pages exist, ahead of the pages themselves being published.
+			void reserve_dirty_blocks(size_t page_count)
+			{
+				if constexpr (track_dirty_blocks)
+				{
+					dirty_blocks.reserve(page_count);
+				}
+			}
+
 			size_t pages_allocated() const
 			{
 				return static_cast<size_t>(pages.size());
@@ -909,13 +2587,103 @@ namespace immutableoctet
 				return pages[native_page_index].data();
 			}
 
-			size_t resize_pages(size_t pages_to_hold, T default_element_value)
+			/*
+				Returns the first index in [`begin`, `end`) whose bit matches `value`, or `end` if there isn't one.
+
+				Population counters aren't consulted to skip pages: each counter is updated after its word,
+				so a page may briefly look empty (or full) even though a completed write says otherwise.
+			*/
+			index_t find_next_in_range(index_t begin, index_t end, value_type value) const
+			{
+				auto result = end;
+
+				for_each_word_mask
+				(
+					begin, end,
+
+					[this, value, &result](word_index_t word_index, underlying_type mask)
+					{
+						const auto word = get_word(word_index).load();
+						const auto candidates = static_cast<underlying_type>(((value) ? word : static_cast<underlying_type>(~word)) & mask);
+
+						if (candidates == underlying_type {})
+						{
+							return true;
+						}
+
+						result = static_cast<index_t>
+						(
+							(word_index * static_cast<word_index_t>(bit_stride))
+							+
+							static_cast<word_index_t>(std::countr_zero(candidates))
+						);
+
+						return false;
+					}
+				);
+
+				return result;
+			}
+
+			/*
+				Executes `callback(word_index, mask)` for each word overlapping [`begin`, `end`),
+				where `mask` covers the portion of the word within that range.
+
+				Iteration stops early if `callback` returns false, in which case
+				the first index of the rejected word (or `begin`) is returned. Otherwise, `end` is returned.
+			*/
+			template <typename Callback>
+			static index_t for_each_word_mask(index_t begin, index_t end, Callback&& callback)
+			{
+				auto index = begin;
+
+				while (index < end)
+				{
+					const auto word_index = resolve_word_index(index);
+					const auto bit_offset = resolve_bit_offset_from_index(index);
+					const auto bit_count = std::min((static_cast<size_t>(bit_stride) - static_cast<size_t>(bit_offset)), static_cast<size_t>(end - index));
+
+					const auto mask = impl::make_bit_range_mask<underlying_type>(bit_offset, bit_count);
+
+					if (!callback(word_index, mask))
+					{
+						return index;
+					}
+
+					index += static_cast<index_t>(bit_count);
+				}
+
+				return end;
+			}
+
+			void release_bits(index_t begin, index_t end)
+			{
+				for_each_word_mask
+				(
+					begin, end,
+
+					[this](word_index_t word_index, underlying_type mask)
+					{
+						fetch_and_mask(word_index, static_cast<underlying_type>(~mask));
+
+						return true;
+					}
+				);
+			}
+
+			size_t resize_pages(size_t pages_to_hold, T element_value)
 			{
 				auto resize_lock = std::scoped_lock { resize_mutex };
 
+				reserve_dirty_blocks(pages_to_hold);
+				reserve_population_counters(pages_to_hold, element_value);
+
 				while (pages_allocated() < pages_to_hold)
 				{
-					pages.emplace_back(default_element_value);
+					if ((element_value != spare_page_value) || (!try_emplace_spare_page()))
+					{
+						pages.emplace_back(element_value);
+					}
 				}
 
 				return pages_allocated();
@@ -931,12 +2699,101 @@ namespace immutableoctet
 				{
 					auto resize_lock = std::scoped_lock { resize_mutex };
 
+					reserve_dirty_blocks(pages_to_hold);
+					reserve_population_counters(pages_to_hold, underlying_type {});
+
+					while ((pages_allocated() < pages_to_hold) && (try_emplace_spare_page())) {}
+
 					pages.resize(static_cast<std::size_t>(pages_to_hold));
 
 					return pages_allocated();
 				}
 			}
 
+			// Executes `callback(i, get(indices[i]))` for each index in order, prefetching ahead of the lookups (see `get_many`).
+			template <typename Callback>
+			void probe_many(std::span<const index_t> indices, Callback&& callback) const
+			{
+				const auto lookup_count = indices.size();
+
+				// Stage one: the page's entry in `pages`, which holds the pointer to its elements.
+				auto prefetch_page_entry = [this](index_t index)
+				{
+					const auto page_index = static_cast<size_t>(resolve_page_index(index));
+
+					if (page_index < pages_allocated())
+					{
+						impl::prefetch(&pages[page_index]);
+					}
+				};
+
+				// Stage two: the word itself, now that the page pointer should be cached.
+				auto prefetch_word = [this](index_t index)
+				{
+					if (const auto* elements = get_page_data(resolve_page_index(index)))
+					{
+						impl::prefetch((elements + resolve_element_index(index)));
+					}
+				};
+
+				for (auto lookup_index = size_t {}; lookup_index < std::min(lookup_count, (lookup_prefetch_distance * 2)); lookup_index++)
+				{
+					prefetch_page_entry(indices[lookup_index]);
+				}
+
+				for (auto lookup_index = size_t {}; lookup_index < std::min(lookup_count, lookup_prefetch_distance); lookup_index++)
+				{
+					prefetch_word(indices[lookup_index]);
+				}
+
+				for (auto lookup_index = size_t {}; lookup_index < lookup_count; lookup_index++)
+				{
+					if ((lookup_index + (lookup_prefetch_distance * 2)) < lookup_count)
+					{
+						prefetch_page_entry(indices[(lookup_index + (lookup_prefetch_distance * 2))]);
+					}
+
+					if ((lookup_index + lookup_prefetch_distance) < lookup_count)
+					{
+						prefetch_word(indices[(lookup_index + lookup_prefetch_distance)]);
+					}
+
+					callback(lookup_index, get(indices[lookup_index]));
+				}
+			}
+
+			// Ensures the page vector can take every spare page without reallocating, growing it geometrically.
+			void reserve_spare_page_entries()
+			{
+				if constexpr (preallocate_pages)
+				{
+					auto resize_lock = std::scoped_lock { resize_mutex };
+
+					const auto required_capacity = (pages_allocated() + spare_pages.target());
+
+					if (required_capacity > pages.capacity())
+					{
+						pages.reserve(std::max(required_capacity, (pages.capacity() * static_cast<size_t>(2))));
+					}
+				}
+			}
+
+			// Appends a page from the spare page pool, if one is immediately available.
+			bool try_emplace_spare_page()
+			{
+				if constexpr (preallocate_pages)
+				{
+					if (auto spare_page = spare_pages.try_take())
+					{
+						pages.push_back(std::move(*spare_page));
+
+						return true;
+					}
+				}
+
+				return false;
+			}
+
 			page_type& allocate_page()
 			{
 				return pages.emplace_back();
@@ -965,6 +2822,11 @@ namespace immutableoctet
 
 			container_type pages;
 
+			[[no_unique_address]] std::conditional_t<track_dirty_blocks, impl::segmented_table<dirty_map_type>, impl::disabled_feature> dirty_blocks;
+			[[no_unique_address]] std::conditional_t<track_population, impl::segmented_table<population_counter_type>, impl::disabled_feature> page_populations;
+
+			[[no_unique_address]] std::conditional_t<preallocate_pages, spare_page_pool_type, impl::disabled_feature> spare_pages;
+
 		private:
 			std::recursive_mutex resize_mutex;
 	};
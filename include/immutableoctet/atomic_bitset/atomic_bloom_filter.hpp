@@ -0,0 +1,311 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <vector>
+#include <array>
+#include <span>
+#include <functional>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	namespace impl
+	{
+		// A single cache line of atomic words; the unit of work for `basic_atomic_bloom_filter`.
+		struct alignas(64) atomic_bloom_block
+		{
+			using word_type = std::uint64_t;
+
+			inline static constexpr std::size_t word_count = 8;
+
+			std::array<std::atomic<word_type>, word_count> words = {};
+		};
+
+		// Finalizer from SplitMix64; spreads weak hashes (e.g. `std::hash` of integers) across all 64 bits.
+		constexpr std::uint64_t mix_hash(std::uint64_t value)
+		{
+			value ^= (value >> 30);
+			value *= 0xBF58476D1CE4E5B9ull;
+			value ^= (value >> 27);
+			value *= 0x94D049BB133111EBull;
+			value ^= (value >> 31);
+
+			return value;
+		}
+	}
+
+	/*
+		Concurrent split-block Bloom filter.
+
+		Each key maps to a single 64-byte block, and sets exactly one bit in each of the block's eight words.
+		The per-word bit positions are derived from one multiply-shift per word, so building the masks
+		is branch-free and vectorizes well. Insertion is one `fetch_or` per word; lookups are eight loads
+		combined without branching.
+
+		Blocks are stored in `fixed_size_atomic_page`s, allocated when the filter is constructed.
+		The block count can't change afterward, since it determines which block each key maps to.
+	*/
+	template
+	<
+		// The type of key being inserted.
+		typename KeyType,
+
+		// Hash function applied to keys; its result is re-mixed, so identity hashes are fine.
+		typename Hash=std::hash<KeyType>,
+
+		// Controls the number of blocks allocated for each page of memory.
+		std::size_t fixed_page_size=64
+	>
+	class basic_atomic_bloom_filter
+	{
+		public:
+			using key_type = KeyType;
+			using hasher = Hash;
+
+			using block_type = impl::atomic_bloom_block;
+			using underlying_type = typename block_type::word_type;
+			using page_type = fixed_size_atomic_page<underlying_type, fixed_page_size, block_type>;
+			using container_type = std::vector<page_type>;
+
+			using size_t = std::size_t;
+			using block_index_t = size_t;
+
+			inline static constexpr size_t page_size = static_cast<size_t>(fixed_page_size);
+			inline static constexpr size_t words_per_block = block_type::word_count;
+			inline static constexpr size_t bits_per_block = (words_per_block * sizeof(underlying_type) * 8);
+
+			// The number of keys looked ahead (and prefetched) by `insert_many` and `contains_many`.
+			inline static constexpr size_t prefetch_distance = 8;
+
+			// The number of bits set for each key.
+			inline static constexpr size_t hash_count = words_per_block;
+
+			// Odd multipliers used to derive one bit position per word (the same salts as Parquet's split-block filter).
+			inline static constexpr std::array<std::uint32_t, words_per_block> salts =
+			{
+				0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+				0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+			};
+
+			// Allocates enough blocks to hold `expected_keys` keys with roughly `bits_per_key` bits each.
+			explicit basic_atomic_bloom_filter(size_t expected_keys, size_t bits_per_key=10, hasher hash_function={}) :
+				hash_function(std::move(hash_function)),
+				block_count(std::max(((expected_keys * bits_per_key) + (bits_per_block - static_cast<size_t>(1))) / bits_per_block, static_cast<size_t>(1)))
+			{
+				const auto page_count = ((block_count + (page_size - static_cast<size_t>(1))) / page_size);
+
+				pages.reserve(page_count);
+
+				for (auto page_index = size_t {}; page_index < page_count; page_index++)
+				{
+					pages.emplace_back();
+				}
+			}
+
+			basic_atomic_bloom_filter(basic_atomic_bloom_filter&&) noexcept = default;
+			basic_atomic_bloom_filter& operator=(basic_atomic_bloom_filter&&) noexcept = default;
+
+			basic_atomic_bloom_filter(const basic_atomic_bloom_filter&) = delete;
+			basic_atomic_bloom_filter& operator=(const basic_atomic_bloom_filter&) = delete;
+
+			// Inserts `key`, returning true if it may already have been present.
+			bool insert(const key_type& key)
+			{
+				return insert_hash(hash_key(key));
+			}
+
+			// Returns false if `key` was definitely never inserted.
+			bool contains(const key_type& key) const
+			{
+				return contains_hash(hash_key(key));
+			}
+
+			void insert_many(std::span<const key_type> keys)
+			{
+				for_each_prefetched_hash
+				(
+					keys,
+
+					[this](size_t, underlying_type hash)
+					{
+						insert_hash(hash);
+					}
+				);
+			}
+
+			// Writes the result of `contains` for each key to the corresponding position of `results`.
+			void contains_many(std::span<const key_type> keys, std::span<bool> results) const
+			{
+				assert(results.size() >= keys.size());
+
+				for_each_prefetched_hash
+				(
+					keys,
+
+					[this, results](size_t key_index, underlying_type hash)
+					{
+						results[key_index] = contains_hash(hash);
+					}
+				);
+			}
+
+			// Resets every bit in the filter. Not atomic with respect to concurrent insertions.
+			void clear()
+			{
+				for (auto block_index = block_index_t {}; block_index < block_count; block_index++)
+				{
+					for (auto& word : get_block(block_index).words)
+					{
+						word.store(underlying_type {}, std::memory_order_relaxed);
+					}
+				}
+			}
+
+			size_t blocks() const
+			{
+				return block_count;
+			}
+
+			size_t size_in_bits() const
+			{
+				return (block_count * bits_per_block);
+			}
+
+			size_t page_count() const
+			{
+				return static_cast<size_t>(pages.size());
+			}
+
+		protected:
+			bool insert_hash(underlying_type hash)
+			{
+				auto& block = get_block(resolve_block_index(hash));
+
+				const auto masks = make_masks(hash);
+
+				auto missing_bits = underlying_type {};
+
+				for (auto word_index = size_t {}; word_index < words_per_block; word_index++)
+				{
+					const auto previous_value = block.words[word_index].fetch_or(masks[word_index]);
+
+					missing_bits |= (masks[word_index] & ~previous_value);
+				}
+
+				return (missing_bits == underlying_type {});
+			}
+
+			bool contains_hash(underlying_type hash) const
+			{
+				const auto& block = get_block(resolve_block_index(hash));
+
+				const auto masks = make_masks(hash);
+
+				auto missing_bits = underlying_type {};
+
+				for (auto word_index = size_t {}; word_index < words_per_block; word_index++)
+				{
+					missing_bits |= (masks[word_index] & ~block.words[word_index].load(std::memory_order_relaxed));
+				}
+
+				return (missing_bits == underlying_type {});
+			}
+
+			underlying_type hash_key(const key_type& key) const
+			{
+				return impl::mix_hash(static_cast<underlying_type>(hash_function(key)));
+			}
+
+			// Maps the upper half of the hash onto [0, `block_count`) without a division.
+			block_index_t resolve_block_index(underlying_type hash) const
+			{
+				return static_cast<block_index_t>(((hash >> 32) * static_cast<underlying_type>(block_count)) >> 32);
+			}
+
+			static std::array<underlying_type, words_per_block> make_masks(underlying_type hash)
+			{
+				const auto key_bits = static_cast<std::uint32_t>(hash);
+
+				auto masks = std::array<underlying_type, words_per_block> {};
+
+				for (auto word_index = size_t {}; word_index < words_per_block; word_index++)
+				{
+					const auto bit_index = static_cast<std::uint32_t>(key_bits * salts[word_index]) >> 26;
+
+					masks[word_index] = (static_cast<underlying_type>(1) << bit_index);
+				}
+
+				return masks;
+			}
+
+			block_type& get_block(block_index_t block_index)
+			{
+				assert(block_index < block_count);
+
+				return pages[(block_index / page_size)].data()[(block_index % page_size)];
+			}
+
+			const block_type& get_block(block_index_t block_index) const
+			{
+				assert(block_index < block_count);
+
+				return pages[(block_index / page_size)].data()[(block_index % page_size)];
+			}
+
+			// Hashes `key` and prefetches its block, returning the hash for later use.
+			underlying_type prefetch_key(const key_type& key) const
+			{
+				const auto hash = hash_key(key);
+
+				impl::prefetch(&get_block(resolve_block_index(hash)));
+
+				return hash;
+			}
+
+			/*
+				Executes `callback(key_index, hash)` for each key in order, prefetching blocks `prefetch_distance` keys ahead.
+
+				The hashes computed for prefetching are kept in a small ring until their keys are reached,
+				so each key is only hashed once.
+			*/
+			template <typename Callback>
+			void for_each_prefetched_hash(std::span<const key_type> keys, Callback&& callback) const
+			{
+				auto pending_hashes = std::array<underlying_type, prefetch_distance> {};
+
+				for (auto key_index = size_t {}; key_index < std::min(keys.size(), prefetch_distance); key_index++)
+				{
+					pending_hashes[key_index] = prefetch_key(keys[key_index]);
+				}
+
+				for (auto key_index = size_t {}; key_index < keys.size(); key_index++)
+				{
+					auto& pending_hash = pending_hashes[(key_index % prefetch_distance)];
+
+					const auto hash = pending_hash;
+
+					if ((key_index + prefetch_distance) < keys.size())
+					{
+						pending_hash = prefetch_key(keys[(key_index + prefetch_distance)]);
+					}
+
+					callback(key_index, hash);
+				}
+			}
+
+			hasher hash_function;
+
+			size_t block_count;
+
+			container_type pages;
+	};
+
+	template <typename KeyType, typename Hash=std::hash<KeyType>>
+	using atomic_bloom_filter = basic_atomic_bloom_filter<KeyType, Hash>;
+}
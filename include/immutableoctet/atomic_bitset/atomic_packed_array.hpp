@@ -0,0 +1,385 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	/*
+		Dynamically sized array of small atomic integers (e.g. 2-bit states, 4-bit saturating counters),
+		packed several to a word.
+
+		Fields never straddle words, so every operation on a field is a single-word atomic operation.
+		Storage, paging and growth are provided by `basic_atomic_bitset`, with field `i` occupying
+		bits [`i * bits_per_field`, `(i + 1) * bits_per_field`) of the underlying bitset.
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store fields.
+		typename T,
+
+		// The width of each field, in bits. Must evenly divide the width of `T`.
+		std::size_t bits_per_field,
+
+		// Controls the number of elements allocated for each page of memory.
+		std::size_t fixed_page_size
+	>
+	class basic_atomic_packed_array
+	{
+		public:
+			using storage_type = basic_atomic_bitset<T, fixed_page_size>;
+
+			using underlying_type = T;
+			using element_type    = typename storage_type::element_type;
+
+			using value_type = underlying_type;
+
+			using size_t = std::size_t;
+
+			using index_t      = size_t;
+			using word_index_t = typename storage_type::word_index_t;
+
+			inline static constexpr size_t field_bits      = bits_per_field;
+			inline static constexpr size_t bit_stride      = storage_type::bit_stride;
+			inline static constexpr size_t page_size       = storage_type::page_size;
+			inline static constexpr size_t fields_per_word = (bit_stride / field_bits);
+
+			static_assert((field_bits > 0), "Fields must be at least one bit wide");
+			static_assert(((bit_stride % field_bits) == 0), "`bits_per_field` must evenly divide the width of `T`");
+
+			// The largest value a field can hold.
+			inline static constexpr underlying_type max_value = impl::make_bit_range_mask<underlying_type>(0, field_bits);
+
+			// The number of distinct values a field can hold; the size of `histogram`'s result.
+			inline static constexpr size_t value_count = (static_cast<size_t>(1) << std::min(field_bits, static_cast<size_t>(16)));
+
+			using histogram_type = std::array<size_t, value_count>;
+
+			basic_atomic_packed_array() = default;
+
+			explicit basic_atomic_packed_array(size_t initial_size)
+			{
+				resize(initial_size);
+			}
+
+			basic_atomic_packed_array(const basic_atomic_packed_array&) = delete;
+			basic_atomic_packed_array& operator=(const basic_atomic_packed_array&) = delete;
+
+			static constexpr word_index_t resolve_word_index(index_t index)
+			{
+				return storage_type::resolve_word_index(resolve_bit_index(index));
+			}
+
+			static constexpr size_t resolve_field_shift(index_t index)
+			{
+				return static_cast<size_t>(storage_type::resolve_bit_offset_from_index(resolve_bit_index(index)));
+			}
+
+			value_type load(index_t index) const
+			{
+				const auto* element = storage.try_get_word(resolve_word_index(index));
+
+				if (!element)
+				{
+					return {};
+				}
+
+				return extract_field(element->load(), resolve_field_shift(index));
+			}
+
+			// Stores `value` to the field at `index`, returning the field's previous value.
+			value_type store(index_t index, value_type value)
+			{
+				assert(value <= max_value);
+
+				return update_field
+				(
+					index,
+
+					[value](value_type)
+					{
+						return value;
+					}
+				);
+			}
+
+			// Stores `desired` if the field at `index` holds `expected`; otherwise, `expected` is updated with the field's value.
+			bool compare_exchange(index_t index, value_type& expected, value_type desired)
+			{
+				assert(desired <= max_value);
+
+				auto& element = storage.get_word(resolve_word_index(index));
+
+				const auto field_shift = resolve_field_shift(index);
+
+				auto word = element.load();
+
+				do
+				{
+					const auto current_value = extract_field(word, field_shift);
+
+					if (current_value != expected)
+					{
+						expected = current_value;
+
+						return false;
+					}
+				}
+				while (!element.compare_exchange_weak(word, replace_field(word, field_shift, desired)));
+
+				return true;
+			}
+
+			// Adds `increment` to the field at `index`, clamping at `max_value`. Returns the field's previous value.
+			value_type fetch_add_saturating(index_t index, value_type increment=1)
+			{
+				return update_field
+				(
+					index,
+
+					[increment](value_type value)
+					{
+						return ((max_value - value) < increment)
+							? max_value
+							: static_cast<value_type>(value + increment)
+						;
+					}
+				);
+			}
+
+			// Subtracts `decrement` from the field at `index`, clamping at zero. Returns the field's previous value.
+			value_type fetch_sub_saturating(index_t index, value_type decrement=1)
+			{
+				return update_field
+				(
+					index,
+
+					[decrement](value_type value)
+					{
+						return (value < decrement)
+							? value_type {}
+							: static_cast<value_type>(value - decrement)
+						;
+					}
+				);
+			}
+
+			/*
+				Halves every field (e.g. to age clock/LRU counters or periodically reset a counting sketch).
+				Each word is updated with one shift and mask, applying to all of its fields at once.
+				Every word is updated atomically, but the array as a whole isn't.
+			*/
+			void decay_all()
+			{
+				for_each_word_segment
+				(
+					storage,
+
+					[](element_type* words, size_t word_count)
+					{
+						for (auto word_index = size_t {}; word_index < word_count; word_index++)
+						{
+							auto& element = words[word_index];
+
+							auto word = element.load(std::memory_order_relaxed);
+
+							while ((word != underlying_type {}) && (!element.compare_exchange_weak(word, static_cast<underlying_type>((word >> 1) & ~high_bits)))) {}
+						}
+					}
+				);
+			}
+
+			// Counts the number of fields holding each possible value.
+			histogram_type histogram() const
+			{
+				static_assert((field_bits <= 16), "Histograms are only available for fields of 16 bits or fewer");
+
+				auto result = histogram_type {};
+
+				const auto field_count = size();
+				const auto full_word_count = static_cast<size_t>(field_count / fields_per_word);
+
+				auto word_index = size_t {};
+
+				for_each_word_segment
+				(
+					storage,
+
+					[&result, &word_index, full_word_count](const element_type* words, size_t word_count)
+					{
+						const auto full_words = std::min(word_count, (full_word_count - std::min(word_index, full_word_count)));
+
+						for (auto word_offset = size_t {}; word_offset < full_words; word_offset++)
+						{
+							count_word_fields(result, words[word_offset].load(std::memory_order_relaxed), fields_per_word);
+						}
+
+						word_index += full_words;
+					}
+				);
+
+				// The final word may only be partially in use.
+				const auto remaining_fields = static_cast<size_t>(field_count % fields_per_word);
+
+				if (remaining_fields > 0)
+				{
+					const auto word = storage.get_word(static_cast<word_index_t>(full_word_count)).load(std::memory_order_relaxed);
+
+					count_word_fields(result, word, remaining_fields);
+				}
+
+				return result;
+			}
+
+			value_type operator[](index_t index) const
+			{
+				return load(index);
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			// The number of fields in the array.
+			size_t size() const
+			{
+				return (storage.size() / field_bits);
+			}
+
+			size_t capacity() const
+			{
+				return (storage.capacity() / field_bits);
+			}
+
+			size_t resize(size_t requested_size)
+			{
+				storage.resize(resolve_bit_index(requested_size));
+
+				return size();
+			}
+
+			size_t reserve(size_t requested_size)
+			{
+				storage.reserve(resolve_bit_index(requested_size));
+
+				return capacity();
+			}
+
+			// Grows the array to include `index`, if needed.
+			size_t request_index(index_t index)
+			{
+				storage.request_index((resolve_bit_index(index) + static_cast<index_t>(field_bits - static_cast<size_t>(1))));
+
+				return size();
+			}
+
+			const storage_type& get_storage() const
+			{
+				return storage;
+			}
+
+		protected:
+			// The lowest and highest bit of every field in a word, respectively.
+			inline static constexpr underlying_type low_bits = static_cast<underlying_type>(static_cast<underlying_type>(~underlying_type {}) / max_value);
+			inline static constexpr underlying_type high_bits = static_cast<underlying_type>(low_bits << (field_bits - static_cast<size_t>(1)));
+
+			static constexpr index_t resolve_bit_index(index_t index)
+			{
+				return static_cast<index_t>(index * static_cast<index_t>(field_bits));
+			}
+
+			static constexpr value_type extract_field(underlying_type word, size_t field_shift)
+			{
+				return static_cast<value_type>((word >> field_shift) & max_value);
+			}
+
+			static constexpr underlying_type replace_field(underlying_type word, size_t field_shift, value_type value)
+			{
+				const auto field_mask = static_cast<underlying_type>(max_value << field_shift);
+
+				return static_cast<underlying_type>((word & ~field_mask) | static_cast<underlying_type>(static_cast<underlying_type>(value) << field_shift));
+			}
+
+			// Tallies the first `field_count` fields of `word` into `result`.
+			static void count_word_fields(histogram_type& result, underlying_type word, size_t field_count)
+			{
+				if constexpr (value_count <= fields_per_word)
+				{
+					if (field_count == fields_per_word)
+					{
+						// Narrow fields: count every occurrence of each value across the word at once.
+						// After XOR-ing with `value`, matching fields are zero. Adding `value_bits` carries into a field's
+						// high bit if any of its lower bits are set, so a field is zero if neither that carry nor its own high bit is set.
+						constexpr auto value_bits = static_cast<underlying_type>(~high_bits);
+
+						for (auto value = size_t {}; value < value_count; value++)
+						{
+							const auto difference = static_cast<underlying_type>(word ^ static_cast<underlying_type>(low_bits * static_cast<underlying_type>(value)));
+							const auto carries = static_cast<underlying_type>((difference & value_bits) + value_bits);
+							const auto zero_fields = static_cast<underlying_type>(~(carries | difference | value_bits));
+
+							result[value] += static_cast<size_t>(std::popcount(zero_fields));
+						}
+
+						return;
+					}
+				}
+
+				for (auto field_index = size_t {}; field_index < field_count; field_index++)
+				{
+					result[static_cast<size_t>(extract_field(word, (field_index * field_bits)))]++;
+				}
+			}
+
+			// Atomically replaces the field at `index` with `operation(current_value)`, returning the previous value.
+			template <typename Operation>
+			value_type update_field(index_t index, Operation&& operation)
+			{
+				auto& element = storage.get_word(resolve_word_index(index));
+
+				const auto field_shift = resolve_field_shift(index);
+
+				auto word = element.load();
+
+				while (!element.compare_exchange_weak(word, replace_field(word, field_shift, operation(extract_field(word, field_shift))))) {}
+
+				return extract_field(word, field_shift);
+			}
+
+			// Executes `callback(words, word_count)` for each page-contiguous run of words in use.
+			template <typename StorageType, typename Callback>
+			static void for_each_word_segment(StorageType& storage, Callback&& callback)
+			{
+				const auto word_count = static_cast<size_t>((storage.size() + (bit_stride - static_cast<size_t>(1))) / bit_stride);
+
+				for (auto word_index = size_t {}; word_index < word_count; word_index += page_size)
+				{
+					auto* words = storage.try_get_word(static_cast<word_index_t>(word_index));
+
+					assert(words);
+
+					callback(words, std::min(page_size, (word_count - word_index)));
+				}
+			}
+
+			storage_type storage;
+	};
+
+	// 2-bit fields (e.g. tri-state flags), packed 32 to a 64-bit word.
+	using atomic_packed_array_2 = basic_atomic_packed_array<std::uint64_t, 2, 512>;
+
+	// 4-bit fields (e.g. saturating counters), packed 16 to a 64-bit word.
+	using atomic_packed_array_4 = basic_atomic_packed_array<std::uint64_t, 4, 512>;
+
+	// 8-bit fields, packed 8 to a 64-bit word.
+	using atomic_packed_array_8 = basic_atomic_packed_array<std::uint64_t, 8, 512>;
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <array>
+#include <initializer_list>
+#include <algorithm>
+#include <type_traits>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	namespace impl
+	{
+		// The smallest unsigned integral type holding `bit_count` bits, up to 64.
+		template <std::size_t bit_count>
+		using smallest_word_t = std::conditional_t
+		<
+			(bit_count <= 8), std::uint8_t,
+
+			std::conditional_t
+			<
+				(bit_count <= 16), std::uint16_t,
+
+				std::conditional_t
+				<
+					(bit_count <= 32), std::uint32_t,
+
+					std::uint64_t
+				>
+			>
+		>;
+
+		/*
+			The default number of words in each of a family's pages: as many whole IDs as fit in 4 KiB,
+			so that no ID's words straddle two pages (or one ID's worth, for families too wide to fit).
+		*/
+		template <std::size_t set_count>
+		inline constexpr std::size_t default_family_page_size = []()
+		{
+			constexpr auto word_size = sizeof(smallest_word_t<set_count>);
+			constexpr auto bits_per_word = (word_size * 8);
+			constexpr auto words_per_id = ((set_count + (bits_per_word - 1)) / bits_per_word);
+
+			return std::max(((4096 / word_size) / words_per_id), static_cast<std::size_t>(1)) * words_per_id;
+		}();
+	}
+
+	/*
+		A family of `set_count` bitsets over the same ID space, stored transposed.
+
+		Each ID's membership across every set is held in one word (or, for more than 64 sets, a few consecutive words),
+		so asking which sets an ID belongs to is a single load, and multi-set predicates over a range of IDs
+		("in A and B, but not C") run over contiguous words.
+
+		Storage, paging and growth are provided by `basic_atomic_bitset`, with the bit for (`set_index`, `id`) stored at
+		`(id * bits_per_id) + set_index`.
+	*/
+	template
+	<
+		// The number of sets in the family.
+		std::size_t set_count,
+
+		// Controls the number of elements allocated for each page of memory; defaults to (up to) 4 KiB pages.
+		std::size_t fixed_page_size=impl::default_family_page_size<set_count>
+	>
+	class basic_bitset_family
+	{
+		public:
+			using word_type = impl::smallest_word_t<set_count>;
+
+			using storage_type = basic_atomic_bitset<word_type, fixed_page_size>;
+			using element_type = typename storage_type::element_type;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using id_t         = size_t;
+			using set_index_t  = size_t;
+			using index_t      = typename storage_type::index_t;
+			using word_index_t = typename storage_type::word_index_t;
+
+			inline static constexpr size_t sets = set_count;
+
+			inline static constexpr size_t bit_stride   = storage_type::bit_stride;
+			inline static constexpr size_t page_size    = storage_type::page_size;
+			inline static constexpr size_t words_per_id = ((set_count + (bit_stride - static_cast<size_t>(1))) / bit_stride);
+			inline static constexpr size_t bits_per_id  = (words_per_id * bit_stride);
+
+			static_assert((set_count > 0), "A family must contain at least one set");
+			static_assert(((page_size % words_per_id) == 0), "Each ID's words must not straddle pages");
+
+			// Membership of a single ID across every set, or a selection of sets used as a predicate.
+			using mask_type = std::array<word_type, words_per_id>;
+
+			basic_bitset_family() = default;
+
+			explicit basic_bitset_family(size_t initial_size)
+			{
+				resize(initial_size);
+			}
+
+			basic_bitset_family(const basic_bitset_family&) = delete;
+			basic_bitset_family& operator=(const basic_bitset_family&) = delete;
+
+			// Builds a mask selecting each of `selected_sets`.
+			static constexpr mask_type make_mask(std::initializer_list<set_index_t> selected_sets)
+			{
+				auto mask = mask_type {};
+
+				for (const auto set_index : selected_sets)
+				{
+					assert(set_index < set_count);
+
+					mask[(set_index / bit_stride)] |= static_cast<word_type>(static_cast<word_type>(1) << (set_index % bit_stride));
+				}
+
+				return mask;
+			}
+
+			static constexpr index_t resolve_bit_index(set_index_t set_index, id_t id)
+			{
+				return static_cast<index_t>((id * bits_per_id) + set_index);
+			}
+
+			// Adds `id` to the specified set, growing the family if needed. Returns true if `id` was already a member.
+			value_type enable(set_index_t set_index, id_t id)
+			{
+				assert(set_index < set_count);
+
+				return is_bit_set(storage.speculative_enable(resolve_bit_index(set_index, id)), set_index);
+			}
+
+			// Removes `id` from the specified set. Returns true if `id` was a member.
+			value_type disable(set_index_t set_index, id_t id)
+			{
+				assert(set_index < set_count);
+
+				if (id >= size())
+				{
+					return {};
+				}
+
+				return is_bit_set(storage.disable(resolve_bit_index(set_index, id)), set_index);
+			}
+
+			value_type set(set_index_t set_index, id_t id, value_type value)
+			{
+				return (value)
+					? enable(set_index, id)
+					: disable(set_index, id)
+				;
+			}
+
+			value_type contains(set_index_t set_index, id_t id) const
+			{
+				assert(set_index < set_count);
+
+				return storage.get(resolve_bit_index(set_index, id));
+			}
+
+			// Returns every set `id` belongs to, loading only `words_per_id` words.
+			mask_type membership(id_t id) const
+			{
+				auto result = mask_type {};
+
+				const auto* words = storage.try_get_word(static_cast<word_index_t>(id * words_per_id));
+
+				if (!words)
+				{
+					return result;
+				}
+
+				for (auto word_index = size_t {}; word_index < words_per_id; word_index++)
+				{
+					result[word_index] = words[word_index].load();
+				}
+
+				return result;
+			}
+
+			// Returns true if `id` belongs to every set in `required`, and none of the sets in `excluded`.
+			value_type matches(id_t id, const mask_type& required, const mask_type& excluded={}) const
+			{
+				return matches_membership(membership(id), required, excluded);
+			}
+
+			// Counts the IDs in [`first_id`, `last_id`) which belong to every set in `required`, and none of the sets in `excluded`.
+			size_t count_matching(id_t first_id, id_t last_id, const mask_type& required, const mask_type& excluded={}) const
+			{
+				auto result = size_t {};
+
+				for_each_id_segment
+				(
+					first_id, last_id,
+
+					[&result, &required, &excluded](const element_type* words, id_t, size_t id_count)
+					{
+						for (auto id_offset = size_t {}; id_offset < id_count; id_offset++)
+						{
+							result += static_cast<size_t>(matches_words((words + (id_offset * words_per_id)), required, excluded));
+						}
+					}
+				);
+
+				return result;
+			}
+
+			// Executes `callback(id)` for each ID in [`first_id`, `last_id`) which belongs to every set in `required`, and none of the sets in `excluded`.
+			template <typename Callback>
+			void for_each_matching(id_t first_id, id_t last_id, const mask_type& required, const mask_type& excluded, Callback&& callback) const
+			{
+				for_each_id_segment
+				(
+					first_id, last_id,
+
+					[&callback, &required, &excluded](const element_type* words, id_t segment_first_id, size_t id_count)
+					{
+						for (auto id_offset = size_t {}; id_offset < id_count; id_offset++)
+						{
+							if (matches_words((words + (id_offset * words_per_id)), required, excluded))
+							{
+								callback(static_cast<id_t>(segment_first_id + id_offset));
+							}
+						}
+					}
+				);
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			// The number of IDs covered by the family.
+			size_t size() const
+			{
+				return ((storage.size() + (bits_per_id - static_cast<size_t>(1))) / bits_per_id);
+			}
+
+			size_t capacity() const
+			{
+				return (storage.capacity() / bits_per_id);
+			}
+
+			size_t resize(size_t requested_size)
+			{
+				storage.resize((requested_size * bits_per_id));
+
+				return size();
+			}
+
+			size_t reserve(size_t requested_size)
+			{
+				storage.reserve((requested_size * bits_per_id));
+
+				return capacity();
+			}
+
+			const storage_type& get_storage() const
+			{
+				return storage;
+			}
+
+		protected:
+			static constexpr value_type is_bit_set(word_type word, set_index_t set_index)
+			{
+				return ((word & static_cast<word_type>(static_cast<word_type>(1) << (set_index % bit_stride))) != word_type {});
+			}
+
+			static constexpr value_type matches_membership(const mask_type& membership, const mask_type& required, const mask_type& excluded)
+			{
+				auto mismatches = word_type {};
+
+				for (auto word_index = size_t {}; word_index < words_per_id; word_index++)
+				{
+					mismatches |= static_cast<word_type>((membership[word_index] & required[word_index]) ^ required[word_index]);
+					mismatches |= static_cast<word_type>(membership[word_index] & excluded[word_index]);
+				}
+
+				return (mismatches == word_type {});
+			}
+
+			static value_type matches_words(const element_type* words, const mask_type& required, const mask_type& excluded)
+			{
+				auto mismatches = word_type {};
+
+				for (auto word_index = size_t {}; word_index < words_per_id; word_index++)
+				{
+					const auto word = words[word_index].load(std::memory_order_relaxed);
+
+					mismatches |= static_cast<word_type>((word & required[word_index]) ^ required[word_index]);
+					mismatches |= static_cast<word_type>(word & excluded[word_index]);
+				}
+
+				return (mismatches == word_type {});
+			}
+
+			// Executes `callback(words, first_id, id_count)` for each page-contiguous run of IDs in [`first_id`, `last_id`).
+			template <typename Callback>
+			void for_each_id_segment(id_t first_id, id_t last_id, Callback&& callback) const
+			{
+				constexpr auto ids_per_page = (page_size / words_per_id);
+
+				last_id = std::min(last_id, size());
+
+				for (auto id = first_id; id < last_id; )
+				{
+					const auto id_count = std::min((ids_per_page - (id % ids_per_page)), (last_id - id));
+
+					const auto* words = storage.try_get_word(static_cast<word_index_t>(id * words_per_id));
+
+					assert(words);
+
+					callback(words, id, id_count);
+
+					id += id_count;
+				}
+			}
+
+			storage_type storage;
+	};
+
+	template <std::size_t set_count>
+	using bitset_family = basic_bitset_family<set_count>;
+}
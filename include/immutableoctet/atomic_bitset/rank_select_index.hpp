@@ -0,0 +1,380 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <limits>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	/*
+		Succinct rank/select index built over the pages of a `basic_atomic_bitset`.
+
+		The index stores a cumulative count for each page, a page-relative count for each block
+		of `words_per_block` words, and the block holding every `select_sample_rate`-th set bit.
+		This allows `rank` to be answered with two table lookups and at most `words_per_block` popcounts,
+		and narrows `select` down to a short binary search.
+
+		The index reflects the bitset as of the last call to `refresh`. Writers (or whoever observes writes)
+		are expected to call `invalidate` for the indices they've modified; `refresh` then only recounts those pages.
+	*/
+	template
+	<
+		// The `basic_atomic_bitset` specialization being indexed.
+		typename BitsetType,
+
+		// The number of words summarized by each block-level count.
+		std::size_t words_per_block=8,
+
+		// The number of set bits between each `select` sample.
+		std::size_t select_sample_rate=4096
+	>
+	class basic_rank_select_index
+	{
+		public:
+			using bitset_type = BitsetType;
+
+			using underlying_type = typename bitset_type::underlying_type;
+
+			using size_t       = std::size_t;
+			using index_t      = typename bitset_type::index_t;
+			using page_index_t = typename bitset_type::page_index_t;
+			using word_index_t = typename bitset_type::word_index_t;
+			using block_index_t = size_t;
+
+			// Page-relative counts; a page never holds more than `page_stride` bits.
+			using block_count_type = std::uint32_t;
+
+			inline static constexpr size_t bit_stride  = bitset_type::bit_stride;
+			inline static constexpr size_t page_size   = bitset_type::page_size;
+			inline static constexpr size_t page_stride = bitset_type::page_stride;
+
+			inline static constexpr size_t block_size      = words_per_block;
+			inline static constexpr size_t block_stride    = (block_size * bit_stride);
+			inline static constexpr size_t blocks_per_page = (page_size / block_size);
+
+			inline static constexpr size_t sample_rate = select_sample_rate;
+
+			static_assert((block_size > 0), "Blocks must contain at least one word");
+			static_assert(((page_size % block_size) == 0), "`words_per_block` must evenly divide the bitset's page size");
+			static_assert((page_stride <= static_cast<size_t>(std::numeric_limits<block_count_type>::max())), "Page-relative counts must fit in `block_count_type`");
+			static_assert((sample_rate > 0), "`select_sample_rate` must be non-zero");
+
+			explicit basic_rank_select_index(const bitset_type& target_bitset) :
+				target_bitset(&target_bitset)
+			{
+				rebuild();
+			}
+
+			// Marks the page containing `index` as modified. The page will be recounted by the next call to `refresh`.
+			void invalidate(index_t index)
+			{
+				invalidate_page(bitset_type::resolve_page_index(index));
+			}
+
+			void invalidate_page(page_index_t page_index)
+			{
+				const auto native_page_index = static_cast<std::size_t>(page_index);
+
+				if (native_page_index < stale_pages.size())
+				{
+					stale_pages[native_page_index] = true;
+				}
+			}
+
+			void invalidate_all()
+			{
+				std::fill(stale_pages.begin(), stale_pages.end(), true);
+			}
+
+			// Recounts every page that's been invalidated (or that the bitset has grown into), then updates cumulative counts and samples.
+			void refresh()
+			{
+				const auto updated_size = target_bitset->size();
+
+				if (updated_size != indexed_size)
+				{
+					// The pages holding the old and new boundaries contain partially indexed words.
+					const auto previous_page_count = page_count_for(indexed_size);
+
+					if (previous_page_count > 0)
+					{
+						invalidate_page(static_cast<page_index_t>(previous_page_count - static_cast<size_t>(1)));
+					}
+
+					indexed_size = updated_size;
+
+					const auto updated_page_count = page_count_for(indexed_size);
+
+					page_counts.resize(updated_page_count);
+					page_cumulative_counts.resize((updated_page_count + static_cast<size_t>(1)));
+					block_counts.resize((updated_page_count * blocks_per_page));
+					stale_pages.resize(updated_page_count, true);
+
+					if (updated_page_count > 0)
+					{
+						stale_pages[(updated_page_count - static_cast<size_t>(1))] = true;
+					}
+				}
+
+				for (auto page_index = size_t {}; page_index < stale_pages.size(); page_index++)
+				{
+					if (stale_pages[page_index])
+					{
+						recount_page(page_index);
+
+						stale_pages[page_index] = false;
+					}
+				}
+
+				auto running_count = size_t {};
+
+				for (auto page_index = size_t {}; page_index < page_counts.size(); page_index++)
+				{
+					page_cumulative_counts[page_index] = running_count;
+
+					running_count += page_counts[page_index];
+				}
+
+				page_cumulative_counts.back() = running_count;
+
+				rebuild_select_samples();
+			}
+
+			// Discards all existing counts and recounts the entire bitset.
+			void rebuild()
+			{
+				invalidate_all();
+				refresh();
+			}
+
+			// The number of bits covered by the index, as of the last refresh.
+			size_t size() const
+			{
+				return indexed_size;
+			}
+
+			// The total number of set bits, as of the last refresh.
+			size_t count() const
+			{
+				return page_cumulative_counts.back();
+			}
+
+			// Returns the number of set bits in [0, `index`).
+			size_t rank(index_t index) const
+			{
+				if (static_cast<size_t>(index) >= indexed_size)
+				{
+					return count();
+				}
+
+				const auto block_index = static_cast<block_index_t>(index / static_cast<index_t>(block_stride));
+				const auto* block_words = get_block_words(block_index);
+
+				const auto word_offset = static_cast<size_t>((index / static_cast<index_t>(bit_stride)) % static_cast<index_t>(block_size));
+				const auto bit_offset = bitset_type::resolve_bit_offset_from_index(index);
+
+				auto result = block_rank(block_index);
+
+				for (auto word_index = size_t {}; word_index < word_offset; word_index++)
+				{
+					result += static_cast<size_t>(std::popcount(block_words[word_index].load(std::memory_order_relaxed)));
+				}
+
+				const auto partial_mask = impl::make_bit_range_mask<underlying_type>(0, static_cast<size_t>(bit_offset));
+
+				result += static_cast<size_t>(std::popcount(static_cast<underlying_type>(block_words[word_offset].load(std::memory_order_relaxed) & partial_mask)));
+
+				return result;
+			}
+
+			// Returns the position of the `k`-th set bit (zero-based), if there is one.
+			std::optional<index_t> select(size_t k) const
+			{
+				if (k >= count())
+				{
+					return std::nullopt;
+				}
+
+				const auto sample_index = (k / sample_rate);
+
+				auto low = select_samples[sample_index];
+
+				auto high = ((sample_index + static_cast<size_t>(1)) < select_samples.size())
+					? select_samples[(sample_index + static_cast<size_t>(1))]
+					: (block_counts.size() - static_cast<size_t>(1))
+				;
+
+				// Find the last block whose rank doesn't exceed `k`.
+				while (low < high)
+				{
+					const auto middle = (low + ((high - low + static_cast<size_t>(1)) / static_cast<size_t>(2)));
+
+					if (block_rank(middle) <= k)
+					{
+						low = middle;
+					}
+					else
+					{
+						high = (middle - static_cast<size_t>(1));
+					}
+				}
+
+				const auto block_index = low;
+				const auto* block_words = get_block_words(block_index);
+
+				auto remaining = (k - block_rank(block_index));
+
+				for (auto word_offset = size_t {}; word_offset < block_size; word_offset++)
+				{
+					auto word = load_indexed_word(block_words, block_index, word_offset);
+
+					const auto word_population = static_cast<size_t>(std::popcount(word));
+
+					if (remaining < word_population)
+					{
+						for (; remaining > 0; remaining--)
+						{
+							word &= static_cast<underlying_type>(word - static_cast<underlying_type>(1));
+						}
+
+						return static_cast<index_t>
+						(
+							(block_index * block_stride)
+							+
+							(word_offset * bit_stride)
+							+
+							static_cast<size_t>(std::countr_zero(word))
+						);
+					}
+
+					remaining -= word_population;
+				}
+
+				// Only reachable if the bitset was modified without being invalidated.
+				return std::nullopt;
+			}
+
+		protected:
+			static size_t page_count_for(size_t bit_count)
+			{
+				return ((bit_count + (page_stride - static_cast<size_t>(1))) / page_stride);
+			}
+
+			size_t block_rank(block_index_t block_index) const
+			{
+				return
+				(
+					page_cumulative_counts[(block_index / blocks_per_page)]
+					+
+					static_cast<size_t>(block_counts[block_index])
+				);
+			}
+
+			const typename bitset_type::element_type* get_block_words(block_index_t block_index) const
+			{
+				const auto* block_words = target_bitset->try_get_word(static_cast<word_index_t>(block_index * block_size));
+
+				assert(block_words);
+
+				return block_words;
+			}
+
+			// Loads a word from a block, discarding any bits at or beyond the indexed size.
+			underlying_type load_indexed_word(const typename bitset_type::element_type* block_words, block_index_t block_index, size_t word_offset) const
+			{
+				const auto first_bit = ((block_index * block_stride) + (word_offset * bit_stride));
+
+				if (first_bit >= indexed_size)
+				{
+					return {};
+				}
+
+				const auto word = block_words[word_offset].load(std::memory_order_relaxed);
+				const auto bits_in_range = std::min(bit_stride, (indexed_size - first_bit));
+
+				return static_cast<underlying_type>(word & impl::make_bit_range_mask<underlying_type>(0, bits_in_range));
+			}
+
+			void recount_page(size_t page_index)
+			{
+				auto page_count = size_t {};
+
+				for (auto block_offset = size_t {}; block_offset < blocks_per_page; block_offset++)
+				{
+					const auto block_index = ((page_index * blocks_per_page) + block_offset);
+
+					block_counts[block_index] = static_cast<block_count_type>(page_count);
+
+					if ((block_index * block_stride) >= indexed_size)
+					{
+						continue;
+					}
+
+					const auto* block_words = get_block_words(block_index);
+
+					for (auto word_offset = size_t {}; word_offset < block_size; word_offset++)
+					{
+						page_count += static_cast<size_t>(std::popcount(load_indexed_word(block_words, block_index, word_offset)));
+					}
+				}
+
+				page_counts[page_index] = page_count;
+			}
+
+			void rebuild_select_samples()
+			{
+				const auto sample_count = ((count() + (sample_rate - static_cast<size_t>(1))) / sample_rate);
+
+				select_samples.resize(sample_count);
+
+				auto search_begin = size_t {};
+
+				for (auto sample_index = size_t {}; sample_index < sample_count; sample_index++)
+				{
+					const auto target_rank = (sample_index * sample_rate);
+
+					// Find the first block whose successor's rank exceeds `target_rank`.
+					auto low = search_begin;
+					auto high = (block_counts.size() - static_cast<size_t>(1));
+
+					while (low < high)
+					{
+						const auto middle = (low + ((high - low + static_cast<size_t>(1)) / static_cast<size_t>(2)));
+
+						if (block_rank(middle) <= target_rank)
+						{
+							low = middle;
+						}
+						else
+						{
+							high = (middle - static_cast<size_t>(1));
+						}
+					}
+
+					select_samples[sample_index] = low;
+
+					search_begin = low;
+				}
+			}
+
+			const bitset_type* target_bitset = nullptr;
+
+			size_t indexed_size = {};
+
+			std::vector<size_t> page_counts;
+			std::vector<size_t> page_cumulative_counts = { size_t {} };
+			std::vector<block_count_type> block_counts;
+			std::vector<block_index_t> select_samples;
+			std::vector<bool> stale_pages;
+	};
+
+	using rank_select_index = basic_rank_select_index<atomic_bitset>;
+}
@@ -0,0 +1,478 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <algorithm>
+#include <limits>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+#if defined(_WIN32)
+	// Keep `<windows.h>` from defining `min`/`max` macros (which break `std::min`, `std::numeric_limits<T>::max`, etc.).
+	#if !defined(NOMINMAX)
+		#define NOMINMAX
+		#define IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_NOMINMAX
+	#endif
+
+	#if !defined(WIN32_LEAN_AND_MEAN)
+		#define WIN32_LEAN_AND_MEAN
+		#define IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_WIN32_LEAN_AND_MEAN
+	#endif
+
+	#include <windows.h>
+
+	#if defined(IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_NOMINMAX)
+		#undef NOMINMAX
+		#undef IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_NOMINMAX
+	#endif
+
+	#if defined(IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_WIN32_LEAN_AND_MEAN)
+		#undef WIN32_LEAN_AND_MEAN
+		#undef IMMUTABLEOCTET_ATOMIC_BITSET_DEFINED_WIN32_LEAN_AND_MEAN
+	#endif
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace immutableoctet
+{
+	namespace impl
+	{
+		// The granularity at which virtual memory can be committed.
+		inline std::size_t get_virtual_memory_page_size()
+		{
+			#if defined(_WIN32)
+				auto system_info = SYSTEM_INFO {};
+
+				GetSystemInfo(&system_info);
+
+				return static_cast<std::size_t>(system_info.dwPageSize);
+			#else
+				return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+			#endif
+		}
+
+		// Reserves a range of address space without backing it with memory. Returns null on failure.
+		inline void* reserve_virtual_memory(std::size_t size)
+		{
+			#if defined(_WIN32)
+				return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+			#else
+				auto* address = mmap(nullptr, size, PROT_NONE, (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE), -1, 0);
+
+				return (address == MAP_FAILED)
+					? nullptr
+					: address
+				;
+			#endif
+		}
+
+		// Makes a reserved range accessible. Pages are zero-filled, and only backed by memory once written to.
+		inline bool commit_virtual_memory(void* address, std::size_t size)
+		{
+			#if defined(_WIN32)
+				return (VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr);
+			#else
+				return (mprotect(address, size, (PROT_READ | PROT_WRITE)) == 0);
+			#endif
+		}
+
+		/*
+			Returns the memory backing a committed range to the system, leaving the range accessible and reading as zero.
+			Returns false if the range was left untouched, in which case the caller must zero it themselves.
+
+			Windows has no equivalent which keeps the range readable throughout: `MEM_RESET` and `DiscardVirtualMemory`
+			leave its contents undefined, while decommitting and recommitting it would fault concurrent accesses.
+		*/
+		inline bool discard_virtual_memory(void* address, std::size_t size)
+		{
+			#if defined(_WIN32)
+				static_cast<void>(address);
+				static_cast<void>(size);
+
+				return false;
+			#else
+				return (madvise(address, size, MADV_DONTNEED) == 0);
+			#endif
+		}
+
+		inline void release_virtual_memory(void* address, std::size_t size)
+		{
+			#if defined(_WIN32)
+				static_cast<void>(size);
+
+				VirtualFree(address, 0, MEM_RELEASE);
+			#else
+				munmap(address, size);
+			#endif
+		}
+	}
+
+	/*
+		Atomic bitset backed by a single contiguous range of reserved virtual memory.
+
+		The full range is reserved up front and committed in chunks as the bitset grows, so indexing is
+		a single `base[index / bit_stride]` with no page directory, and growth never moves existing words.
+		Committed memory that's never been written is backed by the system's shared zero page.
+
+		Elements always start out as zero, since that's what freshly committed memory holds.
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store binary data.
+		typename T,
+
+		// The number of bytes committed at a time; rounded up to the system's page size.
+		std::size_t commit_chunk_size=65536
+	>
+	class basic_reserved_atomic_bitset
+	{
+		public:
+			using underlying_type = T;
+
+			using atomic_type  = std::atomic<underlying_type>;
+			using element_type = atomic_type;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using index_t      = size_t;
+			using bit_index_t  = index_t;
+			using word_index_t = size_t;
+
+			using reference       = atomic_bit_reference<T, bit_index_t>;
+			using const_reference = atomic_bit_const_reference<T, bit_index_t>;
+
+			inline static constexpr size_t bits_per_byte = 8;
+			inline static constexpr size_t bit_stride    = (sizeof(underlying_type) * bits_per_byte);
+
+			// 2^40 bits (128 GiB of address space), or half the address space where that's smaller (e.g. 32-bit targets).
+			inline static constexpr size_t default_reserved_size = static_cast<size_t>
+			(
+				std::min<std::uint64_t>
+				(
+					(static_cast<std::uint64_t>(1) << 40),
+					static_cast<std::uint64_t>(std::numeric_limits<size_t>::max() / static_cast<size_t>(2))
+				)
+			);
+
+			static_assert((sizeof(element_type) == sizeof(underlying_type)), "Atomic elements must share the layout of `underlying_type`");
+			static_assert((element_type::is_always_lock_free), "Atomic elements must be lock-free for zero-filled memory to represent them");
+
+			explicit basic_reserved_atomic_bitset(size_t max_size_in_bits=default_reserved_size) :
+				chunk_size(round_up(commit_chunk_size, impl::get_virtual_memory_page_size())),
+				reserved_bytes(round_up(((max_size_in_bits + (bit_stride - static_cast<size_t>(1))) / bit_stride) * sizeof(element_type), chunk_size))
+			{
+				words = static_cast<element_type*>(impl::reserve_virtual_memory(reserved_bytes));
+
+				if (!words)
+				{
+					throw std::bad_alloc {};
+				}
+			}
+
+			~basic_reserved_atomic_bitset()
+			{
+				if (words)
+				{
+					impl::release_virtual_memory(words, reserved_bytes);
+				}
+			}
+
+			basic_reserved_atomic_bitset(const basic_reserved_atomic_bitset&) = delete;
+			basic_reserved_atomic_bitset& operator=(const basic_reserved_atomic_bitset&) = delete;
+
+			static constexpr word_index_t resolve_word_index(index_t index)
+			{
+				return (static_cast<word_index_t>(index) / static_cast<word_index_t>(bit_stride));
+			}
+
+			static constexpr bit_index_t resolve_bit_offset_from_index(index_t index)
+			{
+				return static_cast<bit_index_t>(index % static_cast<index_t>(bit_stride));
+			}
+
+			element_type* try_get_word(word_index_t word_index)
+			{
+				if (word_index >= committed_words.load(std::memory_order_acquire))
+				{
+					return {};
+				}
+
+				return (words + word_index);
+			}
+
+			const element_type* try_get_word(word_index_t word_index) const
+			{
+				if (word_index >= committed_words.load(std::memory_order_acquire))
+				{
+					return {};
+				}
+
+				return (words + word_index);
+			}
+
+			element_type& get_word(word_index_t word_index)
+			{
+				auto* element = try_get_word(word_index);
+
+				assert(element);
+
+				return (*element);
+			}
+
+			const element_type& get_word(word_index_t word_index) const
+			{
+				const auto* element = try_get_word(word_index);
+
+				assert(element);
+
+				return (*element);
+			}
+
+			value_type get(index_t index) const
+			{
+				const auto* element = try_get_word(resolve_word_index(index));
+
+				if (!element)
+				{
+					return {};
+				}
+
+				return impl::get_bit(*element, resolve_bit_offset_from_index(index));
+			}
+
+			underlying_type set(index_t index, value_type value)
+			{
+				return impl::set_bit(get_word(resolve_word_index(index)), resolve_bit_offset_from_index(index), value);
+			}
+
+			underlying_type enable(index_t index)
+			{
+				return impl::enable_bit(get_word(resolve_word_index(index)), resolve_bit_offset_from_index(index));
+			}
+
+			underlying_type disable(index_t index)
+			{
+				return impl::disable_bit(get_word(resolve_word_index(index)), resolve_bit_offset_from_index(index));
+			}
+
+			underlying_type toggle(index_t index)
+			{
+				return impl::toggle_bit(get_word(resolve_word_index(index)), resolve_bit_offset_from_index(index));
+			}
+
+			underlying_type fetch_or_mask(word_index_t word_index, underlying_type mask)
+			{
+				return get_word(word_index).fetch_or(mask);
+			}
+
+			underlying_type fetch_and_mask(word_index_t word_index, underlying_type mask)
+			{
+				return get_word(word_index).fetch_and(mask);
+			}
+
+			underlying_type speculative_set(index_t index, value_type value)
+			{
+				request_index(index);
+
+				return set(index, value);
+			}
+
+			underlying_type speculative_enable(index_t index)
+			{
+				request_index(index);
+
+				return enable(index);
+			}
+
+			underlying_type speculative_disable(index_t index)
+			{
+				request_index(index);
+
+				return disable(index);
+			}
+
+			underlying_type speculative_toggle(index_t index)
+			{
+				request_index(index);
+
+				return toggle(index);
+			}
+
+			reference get_reference(index_t index)
+			{
+				auto* element = try_get_word(resolve_word_index(index));
+
+				if (!element)
+				{
+					return {};
+				}
+
+				return reference { *element, resolve_bit_offset_from_index(index) };
+			}
+
+			const_reference get_reference(index_t index) const
+			{
+				const auto* element = try_get_word(resolve_word_index(index));
+
+				if (!element)
+				{
+					return {};
+				}
+
+				return const_reference { *element, resolve_bit_offset_from_index(index) };
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			size_t size() const
+			{
+				return size_in_bits;
+			}
+
+			// The number of bits currently committed.
+			size_t capacity() const
+			{
+				return (committed_words.load() * bit_stride);
+			}
+
+			// The number of bits the reservation can hold; the bitset can never grow beyond this.
+			size_t max_size() const
+			{
+				return ((reserved_bytes / sizeof(element_type)) * bit_stride);
+			}
+
+			size_t reserve(size_t requested_size)
+			{
+				commit_words(((requested_size + (bit_stride - static_cast<size_t>(1))) / bit_stride));
+
+				return capacity();
+			}
+
+			size_t resize(size_t requested_size)
+			{
+				auto commit_lock = std::scoped_lock { commit_mutex };
+
+				reserve(requested_size);
+
+				size_in_bits = requested_size;
+
+				return size();
+			}
+
+			size_t request_index(index_t requested_index)
+			{
+				const auto index_as_size = static_cast<size_t>(requested_index);
+
+				if (index_as_size >= size())
+				{
+					auto commit_lock = std::scoped_lock { commit_mutex };
+
+					reserve((index_as_size + static_cast<size_t>(1)));
+
+					if (index_as_size >= size())
+					{
+						size_in_bits = (index_as_size + static_cast<size_t>(1));
+					}
+				}
+
+				return size();
+			}
+
+			/*
+				Empties the bitset, returning all committed memory to the system where possible (see `impl::discard_virtual_memory`).
+				The range stays committed and reads as zero; on Windows, it's zeroed in place instead.
+			*/
+			void clear()
+			{
+				auto commit_lock = std::scoped_lock { commit_mutex };
+
+				size_in_bits = 0;
+
+				const auto committed_bytes = (committed_words.load() * sizeof(element_type));
+
+				if ((committed_bytes > 0) && (!impl::discard_virtual_memory(words, committed_bytes)))
+				{
+					const auto word_count = committed_words.load();
+
+					for (auto word_index = size_t {}; word_index < word_count; word_index++)
+					{
+						words[word_index].store(underlying_type {}, std::memory_order_relaxed);
+					}
+				}
+			}
+
+			explicit operator bool() const
+			{
+				return (!empty());
+			}
+
+			value_type operator[](index_t index) const
+			{
+				return get(index);
+			}
+
+			reference operator[](index_t index)
+			{
+				request_index(index);
+
+				return get_reference(index);
+			}
+
+		protected:
+			static constexpr size_t round_up(size_t value, size_t multiple)
+			{
+				return (((value + (multiple - static_cast<size_t>(1))) / multiple) * multiple);
+			}
+
+			void commit_words(size_t word_count)
+			{
+				if (word_count <= committed_words.load())
+				{
+					return;
+				}
+
+				auto commit_lock = std::scoped_lock { commit_mutex };
+
+				const auto current_bytes = (committed_words.load() * sizeof(element_type));
+				const auto requested_bytes = round_up((word_count * sizeof(element_type)), chunk_size);
+
+				if (requested_bytes <= current_bytes)
+				{
+					return;
+				}
+
+				if ((requested_bytes > reserved_bytes) || (!impl::commit_virtual_memory((reinterpret_cast<std::byte*>(words) + current_bytes), (requested_bytes - current_bytes))))
+				{
+					throw std::bad_alloc {};
+				}
+
+				committed_words.store((requested_bytes / sizeof(element_type)), std::memory_order_release);
+			}
+
+			size_t chunk_size;
+			size_t reserved_bytes;
+
+			element_type* words = nullptr;
+
+			std::atomic<size_t> committed_words = { std::size_t {} };
+			std::atomic<size_t> size_in_bits = { std::size_t {} };
+
+		private:
+			std::recursive_mutex commit_mutex;
+	};
+
+	// Defaults to 64-bit unsigned integers, committed 64 KiB at a time.
+	using reserved_atomic_bitset = basic_reserved_atomic_bitset<std::uint64_t>;
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	/*
+		Fixed-memory bitset over a sliding window of unbounded 64-bit indices (e.g. sequence numbers).
+
+		Indices are mapped onto a power-of-two ring of `fixed_size_atomic_page`s. The window starts at `base()`
+		and spans `ring_page_count` pages; setting an index beyond the window slides it forward automatically.
+		Pages which fall out of the window aren't touched until their ring slot is reused, at which point
+		they're cleared by whichever thread gets there first.
+
+		Each slot has a single atomic state word holding the page it currently represents (as the number of times
+		the window has gone around the ring) and the number of operations in flight on it. No operation ever waits
+		on another thread. A slot can only be recycled once the outgoing page's last operation has finished,
+		so an insertion which finds the slot still in use by an older page, or being cleared, reports `busy`
+		instead; the caller may retry it, or defer it. Reads never recycle slots.
+
+		Indices may range up to `max_index()`, which spans the full 64-bit range for windows larger than
+		2^17 bits (e.g. eight pages of the default size).
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store binary data.
+		typename T,
+
+		// Controls the number of elements allocated for each page of memory.
+		std::size_t fixed_page_size
+	>
+	class basic_ring_atomic_bitset
+	{
+		public:
+			using underlying_type = T;
+
+			using atomic_type    = std::atomic<underlying_type>;
+			using element_type   = atomic_type;
+			using page_type      = fixed_size_atomic_page<underlying_type, fixed_page_size, element_type>;
+			using container_type = std::vector<page_type>;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using index_t      = std::uint64_t;
+			using page_index_t = std::uint64_t;
+			using state_type   = std::uint64_t;
+
+			inline static constexpr size_t page_size = static_cast<size_t>(fixed_page_size);
+
+			inline static constexpr size_t bits_per_byte = 8;
+			inline static constexpr size_t bit_stride    = (sizeof(underlying_type) * bits_per_byte);
+			inline static constexpr size_t page_stride   = (static_cast<size_t>(page_size) * bit_stride);
+
+			// Slot states: [63] recycling flag, [62..16] page tag (revolution + 1), [15..0] operations in flight.
+			inline static constexpr state_type user_bits      = 16;
+			inline static constexpr state_type user_mask      = ((static_cast<state_type>(1) << user_bits) - static_cast<state_type>(1));
+			inline static constexpr state_type recycling_flag = (static_cast<state_type>(1) << 63);
+
+			inline static constexpr state_type tag_bits      = (static_cast<state_type>(63) - user_bits);
+			inline static constexpr state_type max_page_tag  = ((static_cast<state_type>(1) << tag_bits) - static_cast<state_type>(1));
+
+			enum class insert_result
+			{
+				// The index was newly set.
+				inserted,
+
+				// The index had already been set.
+				duplicate,
+
+				// The index precedes the window, so it can no longer be tracked.
+				too_old,
+
+				// The index's slot is still in use by an older page, or is being cleared; nothing was written.
+				busy
+			};
+
+			explicit basic_ring_atomic_bitset(size_t ring_page_count, index_t initial_base=index_t {}) :
+				ring_page_count(ring_page_count),
+				ring_mask(static_cast<page_index_t>(ring_page_count - static_cast<size_t>(1))),
+				ring_shift(static_cast<page_index_t>(std::countr_zero(ring_page_count))),
+				base_index(initial_base),
+				slot_states(ring_page_count)
+			{
+				assert(std::has_single_bit(ring_page_count));
+
+				pages.reserve(ring_page_count);
+
+				for (auto page_index = size_t {}; page_index < ring_page_count; page_index++)
+				{
+					pages.emplace_back(underlying_type {});
+				}
+
+				// The initial window's pages are already clear.
+				const auto first_page = resolve_page_index(initial_base);
+
+				for (auto page_index = first_page; page_index < (first_page + static_cast<page_index_t>(ring_page_count)); page_index++)
+				{
+					get_slot_state(page_index).store(make_state(page_index));
+				}
+			}
+
+			basic_ring_atomic_bitset(const basic_ring_atomic_bitset&) = delete;
+			basic_ring_atomic_bitset& operator=(const basic_ring_atomic_bitset&) = delete;
+
+			static constexpr page_index_t resolve_page_index(index_t index)
+			{
+				return static_cast<page_index_t>(index / static_cast<index_t>(page_stride));
+			}
+
+			// The lowest index still tracked by the window.
+			index_t base() const
+			{
+				return base_index.load();
+			}
+
+			// The number of indices covered by the window.
+			size_t capacity() const
+			{
+				return (ring_page_count * page_stride);
+			}
+
+			// The highest index which can be tracked, limited by the width of each slot's page tag.
+			index_t max_index() const
+			{
+				const auto window_size = static_cast<index_t>(capacity());
+				const auto revolutions = static_cast<index_t>(max_page_tag);
+
+				if (window_size > (std::numeric_limits<index_t>::max() / revolutions))
+				{
+					return std::numeric_limits<index_t>::max();
+				}
+
+				return ((window_size * revolutions) - static_cast<index_t>(1));
+			}
+
+			// Moves the start of the window forward to `new_base`; has no effect if the window is already past it.
+			index_t advance_base(index_t new_base)
+			{
+				auto current_base = base_index.load();
+
+				while ((current_base < new_base) && (!base_index.compare_exchange_weak(current_base, new_base))) {}
+
+				return std::max(current_base, new_base);
+			}
+
+			// Sets `index`, reporting whether it was already set. Indices beyond the window slide it forward.
+			insert_result test_and_set(index_t index)
+			{
+				assert(index <= max_index());
+
+				const auto current_base = base_index.load();
+
+				if (index < current_base)
+				{
+					return insert_result::too_old;
+				}
+
+				const auto page_index = resolve_page_index(index);
+				const auto window_end = (resolve_page_index(current_base) + static_cast<page_index_t>(ring_page_count));
+
+				if (page_index >= window_end)
+				{
+					advance_base(((page_index - static_cast<page_index_t>(ring_page_count) + static_cast<page_index_t>(1)) * static_cast<page_index_t>(page_stride)));
+				}
+
+				switch (acquire_slot(page_index, true))
+				{
+					case slot_acquisition::retired:
+						return insert_result::too_old;
+
+					case slot_acquisition::pending:
+						return insert_result::busy;
+
+					default:
+						break;
+				}
+
+				const auto bitmask = make_bit_mask(index);
+				const auto previous_value = get_element(index).fetch_or(bitmask);
+
+				release_slot(page_index);
+
+				return ((previous_value & bitmask) != underlying_type {})
+					? insert_result::duplicate
+					: insert_result::inserted
+				;
+			}
+
+			// Returns true if `index` is within the window and has been set.
+			value_type get(index_t index) const
+			{
+				const auto current_base = base_index.load();
+
+				if (index < current_base)
+				{
+					return {};
+				}
+
+				const auto page_index = resolve_page_index(index);
+
+				if (page_index >= (resolve_page_index(current_base) + static_cast<page_index_t>(ring_page_count)))
+				{
+					return {};
+				}
+
+				// A slot which hasn't started holding the page yet means nothing has been written to it.
+				if (acquire_slot(page_index, false) != slot_acquisition::acquired)
+				{
+					return {};
+				}
+
+				const auto result = ((get_element(index).load() & make_bit_mask(index)) != underlying_type {});
+
+				release_slot(page_index);
+
+				return result;
+			}
+
+			value_type operator[](index_t index) const
+			{
+				return get(index);
+			}
+
+		protected:
+			struct alignas(64) slot_state
+			{
+				std::atomic<state_type> value = { state_type {} };
+			};
+
+			// Outcomes of `acquire_slot`.
+			enum class slot_acquisition
+			{
+				// The slot holds the requested page, and the operation has been registered on it.
+				acquired,
+
+				// The slot has moved on to a newer page.
+				retired,
+
+				// The slot doesn't hold the requested page yet: it still holds an older page, or is being cleared.
+				pending
+			};
+
+			// Pages sharing a slot are told apart by how many times the window has gone around the ring.
+			state_type make_page_tag(page_index_t page_index) const
+			{
+				const auto page_tag = (static_cast<state_type>(page_index >> ring_shift) + static_cast<state_type>(1));
+
+				assert(page_tag <= max_page_tag);
+
+				return page_tag;
+			}
+
+			state_type make_state(page_index_t page_index) const
+			{
+				return (make_page_tag(page_index) << user_bits);
+			}
+
+			static constexpr state_type get_state_page_tag(state_type state)
+			{
+				return ((state & ~recycling_flag) >> user_bits);
+			}
+
+			static constexpr underlying_type make_bit_mask(index_t index)
+			{
+				return static_cast<underlying_type>(static_cast<underlying_type>(1) << static_cast<underlying_type>(index % static_cast<index_t>(bit_stride)));
+			}
+
+			std::atomic<state_type>& get_slot_state(page_index_t page_index) const
+			{
+				return slot_states[static_cast<size_t>(page_index & ring_mask)].value;
+			}
+
+			element_type& get_element(index_t index) const
+			{
+				const auto page_index = resolve_page_index(index);
+				const auto element_index = static_cast<size_t>((index / static_cast<index_t>(bit_stride)) % static_cast<index_t>(page_size));
+
+				return pages[static_cast<size_t>(page_index & ring_mask)].data()[element_index];
+			}
+
+			/*
+				Registers an operation on `page_index`, first recycling its slot if `recycle` is set and
+				the slot holds an older page with no operations in flight. Never waits on other threads.
+			*/
+			slot_acquisition acquire_slot(page_index_t page_index, bool recycle) const
+			{
+				auto& state = get_slot_state(page_index);
+
+				const auto page_tag = make_page_tag(page_index);
+
+				auto current_state = state.load();
+
+				while (true)
+				{
+					const auto current_tag = get_state_page_tag(current_state);
+
+					if (current_tag > page_tag)
+					{
+						return slot_acquisition::retired;
+					}
+
+					if (current_tag == page_tag)
+					{
+						if ((current_state & recycling_flag) != state_type {})
+						{
+							return slot_acquisition::pending;
+						}
+
+						assert((current_state & user_mask) != user_mask);
+
+						if (state.compare_exchange_weak(current_state, (current_state + static_cast<state_type>(1))))
+						{
+							return slot_acquisition::acquired;
+						}
+
+						continue;
+					}
+
+					// The slot still holds a page which has left the window; it can only be cleared once that page's last users are done.
+					if ((!recycle) || ((current_state & (recycling_flag | user_mask)) != state_type {}))
+					{
+						return slot_acquisition::pending;
+					}
+
+					if (state.compare_exchange_weak(current_state, (make_state(page_index) | recycling_flag)))
+					{
+						auto* page_data = pages[static_cast<size_t>(page_index & ring_mask)].data();
+
+						for (auto element_index = size_t {}; element_index < page_size; element_index++)
+						{
+							page_data[element_index].store(underlying_type {}, std::memory_order_relaxed);
+						}
+
+						state.store(make_state(page_index), std::memory_order_release);
+
+						current_state = state.load();
+					}
+				}
+			}
+
+			void release_slot(page_index_t page_index) const
+			{
+				get_slot_state(page_index).fetch_sub(static_cast<state_type>(1));
+			}
+
+			size_t ring_page_count;
+			page_index_t ring_mask;
+			page_index_t ring_shift;
+
+			std::atomic<index_t> base_index;
+
+			/*
+				`get` is const, but registers itself in `slot_states` (as an operation in flight) like any other access.
+				`acquire_slot` and `get_element` are shared by reads and writes, so they're const too, and hand out
+				writable page contents (which `test_and_set` uses to clear recycled slots and set bits).
+			*/
+			mutable container_type pages;
+			mutable std::vector<slot_state> slot_states;
+	};
+
+	// Defaults to 64-bit unsigned integers: 512 x 8 x 8 (4096 bytes, 32768 bits)
+	using ring_atomic_bitset = basic_ring_atomic_bitset<std::uint64_t, 512>;
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	/*
+		Atomic bitset partitioned into independent shards, each a `basic_atomic_bitset` with its own pages,
+		resize mutex and size.
+
+		Pages are dealt out to shards round-robin: page `p` of the index space is page `p / shard_count()`
+		of shard `p % shard_count()`. Growing writes only lock and resize the shard owning the index, so writers
+		growing the bitset in different pages don't contend. Mapping an index to its shard is a shift and a mask.
+
+		Aggregate queries (`size`, `count`, `for_each_enabled`) visit every shard, and aren't snapshots.
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store binary data.
+		typename T,
+
+		// Controls the number of elements allocated for each page of memory.
+		std::size_t fixed_page_size
+	>
+	class basic_sharded_atomic_bitset
+	{
+		public:
+			using shard_type = basic_atomic_bitset<T, fixed_page_size>;
+
+			using underlying_type = T;
+			using element_type    = typename shard_type::element_type;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using index_t       = size_t;
+			using page_index_t  = size_t;
+			using shard_index_t = size_t;
+
+			inline static constexpr size_t page_size   = shard_type::page_size;
+			inline static constexpr size_t bit_stride  = shard_type::bit_stride;
+			inline static constexpr size_t page_stride = shard_type::page_stride;
+
+			// One shard per hardware thread, rounded up to a power of two.
+			static size_t default_shard_count()
+			{
+				return std::bit_ceil(std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1)));
+			}
+
+			explicit basic_sharded_atomic_bitset(size_t shard_count=default_shard_count()) :
+				shard_mask(shard_count - static_cast<size_t>(1)),
+				shard_shift(static_cast<size_t>(std::countr_zero(shard_count))),
+				shards(std::make_unique<padded_shard[]>(shard_count))
+			{
+				assert(std::has_single_bit(shard_count));
+			}
+
+			basic_sharded_atomic_bitset(const basic_sharded_atomic_bitset&) = delete;
+			basic_sharded_atomic_bitset& operator=(const basic_sharded_atomic_bitset&) = delete;
+
+			size_t shard_count() const
+			{
+				return (shard_mask + static_cast<size_t>(1));
+			}
+
+			static constexpr page_index_t resolve_page_index(index_t index)
+			{
+				return static_cast<page_index_t>(index / static_cast<index_t>(page_stride));
+			}
+
+			shard_index_t resolve_shard_index(index_t index) const
+			{
+				return static_cast<shard_index_t>(resolve_page_index(index) & shard_mask);
+			}
+
+			// The index within its shard that `index` is stored at.
+			index_t resolve_local_index(index_t index) const
+			{
+				const auto local_page_index = (resolve_page_index(index) >> shard_shift);
+
+				return static_cast<index_t>((local_page_index * page_stride) + (index % static_cast<index_t>(page_stride)));
+			}
+
+			// The index that `local_index` of `shard_index` corresponds to.
+			index_t resolve_global_index(shard_index_t shard_index, index_t local_index) const
+			{
+				const auto local_page_index = resolve_page_index(local_index);
+				const auto page_index = ((local_page_index << shard_shift) | shard_index);
+
+				return static_cast<index_t>((page_index * page_stride) + (local_index % static_cast<index_t>(page_stride)));
+			}
+
+			shard_type& get_shard(shard_index_t shard_index)
+			{
+				return shards[shard_index].bitset;
+			}
+
+			const shard_type& get_shard(shard_index_t shard_index) const
+			{
+				return shards[shard_index].bitset;
+			}
+
+			value_type get(index_t index) const
+			{
+				return get_shard(resolve_shard_index(index)).get(resolve_local_index(index));
+			}
+
+			underlying_type set(index_t index, value_type value)
+			{
+				return get_shard(resolve_shard_index(index)).set(resolve_local_index(index), value);
+			}
+
+			underlying_type enable(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).enable(resolve_local_index(index));
+			}
+
+			underlying_type disable(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).disable(resolve_local_index(index));
+			}
+
+			underlying_type toggle(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).toggle(resolve_local_index(index));
+			}
+
+			// Sets `index`, growing only the shard which owns it.
+			underlying_type speculative_set(index_t index, value_type value)
+			{
+				return get_shard(resolve_shard_index(index)).speculative_set(resolve_local_index(index), value);
+			}
+
+			underlying_type speculative_enable(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).speculative_enable(resolve_local_index(index));
+			}
+
+			underlying_type speculative_disable(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).speculative_disable(resolve_local_index(index));
+			}
+
+			underlying_type speculative_toggle(index_t index)
+			{
+				return get_shard(resolve_shard_index(index)).speculative_toggle(resolve_local_index(index));
+			}
+
+			value_type operator[](index_t index) const
+			{
+				return get(index);
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			// One past the highest index held by any shard.
+			size_t size() const
+			{
+				auto result = size_t {};
+
+				for (auto shard_index = shard_index_t {}; shard_index < shard_count(); shard_index++)
+				{
+					const auto local_size = get_shard(shard_index).size();
+
+					if (local_size > 0)
+					{
+						result = std::max(result, static_cast<size_t>(resolve_global_index(shard_index, static_cast<index_t>(local_size - static_cast<size_t>(1))) + static_cast<index_t>(1)));
+					}
+				}
+
+				return result;
+			}
+
+			// The number of enabled bits across every shard.
+			size_t count() const
+			{
+				auto result = size_t {};
+
+				for (auto shard_index = shard_index_t {}; shard_index < shard_count(); shard_index++)
+				{
+					result += get_shard(shard_index).count();
+				}
+
+				return result;
+			}
+
+			// Resizes every shard to hold its share of [0, `requested_size`).
+			size_t resize(size_t requested_size)
+			{
+				for (auto shard_index = shard_index_t {}; shard_index < shard_count(); shard_index++)
+				{
+					get_shard(shard_index).resize(resolve_local_size(shard_index, requested_size));
+				}
+
+				return size();
+			}
+
+			// The number of bits allocated across every shard.
+			size_t capacity() const
+			{
+				auto result = size_t {};
+
+				for (auto shard_index = shard_index_t {}; shard_index < shard_count(); shard_index++)
+				{
+					result += get_shard(shard_index).capacity();
+				}
+
+				return result;
+			}
+
+			size_t reserve(size_t requested_size)
+			{
+				for (auto shard_index = shard_index_t {}; shard_index < shard_count(); shard_index++)
+				{
+					get_shard(shard_index).reserve(resolve_local_size(shard_index, requested_size));
+				}
+
+				return capacity();
+			}
+
+			// Executes `callback(index)` for each enabled bit, in ascending order.
+			template <typename Callback>
+			void for_each_enabled(Callback&& callback) const
+			{
+				const auto page_count = ((size() + (page_stride - static_cast<size_t>(1))) / page_stride);
+
+				for (auto page_index = page_index_t {}; page_index < page_count; page_index++)
+				{
+					const auto& shard = get_shard(static_cast<shard_index_t>(page_index & shard_mask));
+
+					const auto local_page_begin = static_cast<index_t>((page_index >> shard_shift) * page_stride);
+					const auto local_page_end = std::min(static_cast<index_t>(local_page_begin + page_stride), static_cast<index_t>(shard.size()));
+
+					if (local_page_begin >= local_page_end)
+					{
+						continue;
+					}
+
+					const auto* words = shard.try_get_word(static_cast<typename shard_type::word_index_t>(local_page_begin / bit_stride));
+
+					if (!words)
+					{
+						continue;
+					}
+
+					const auto word_count = ((static_cast<size_t>(local_page_end - local_page_begin) + (bit_stride - static_cast<size_t>(1))) / bit_stride);
+					const auto page_begin = static_cast<index_t>(page_index * page_stride);
+					const auto page_end = static_cast<index_t>(page_begin + static_cast<index_t>(local_page_end - local_page_begin));
+
+					for (auto word_offset = size_t {}; word_offset < word_count; word_offset++)
+					{
+						auto word = words[word_offset].load(std::memory_order_relaxed);
+
+						while (word != underlying_type {})
+						{
+							const auto index = static_cast<index_t>(page_begin + static_cast<index_t>((word_offset * bit_stride) + static_cast<size_t>(std::countr_zero(word))));
+
+							if (index >= page_end)
+							{
+								break;
+							}
+
+							callback(index);
+
+							word &= static_cast<underlying_type>(word - static_cast<underlying_type>(1));
+						}
+					}
+				}
+			}
+
+		protected:
+			// Keeps each shard's size and mutex off its neighbours' cache lines.
+			struct alignas(64) padded_shard
+			{
+				shard_type bitset;
+			};
+
+			// The number of bits `shard_index` needs to hold its share of [0, `global_size`).
+			size_t resolve_local_size(shard_index_t shard_index, size_t global_size) const
+			{
+				const auto round_stride = (page_stride * shard_count());
+
+				const auto full_rounds = (global_size / round_stride);
+				const auto remainder = (global_size % round_stride);
+
+				const auto shard_begin = (shard_index * page_stride);
+
+				const auto partial_bits = (remainder > shard_begin)
+					? std::min((remainder - shard_begin), page_stride)
+					: size_t {}
+				;
+
+				return ((full_rounds * page_stride) + partial_bits);
+			}
+
+			size_t shard_mask;
+			size_t shard_shift;
+
+			std::unique_ptr<padded_shard[]> shards;
+	};
+
+	// Defaults to 64-bit unsigned integers: 512 x 8 x 8 (4096 bytes, 32768 bits)
+	using sharded_atomic_bitset = basic_sharded_atomic_bitset<std::uint64_t, 512>;
+}
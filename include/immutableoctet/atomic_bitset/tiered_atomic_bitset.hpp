@@ -0,0 +1,829 @@
+#pragma once
+
+#include "atomic_bitset.hpp"
+
+#include <atomic>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <stop_token>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace immutableoctet
+{
+	// The representations a page of a `basic_tiered_atomic_bitset` can take.
+	enum class page_tier : std::uint8_t
+	{
+		// A full, uncompressed page of atomic words.
+		resident,
+
+		// Every bit is disabled; no memory is held.
+		all_zero,
+
+		// Every bit is enabled; no memory is held.
+		all_one,
+
+		// The positions of the page's enabled bits.
+		sparse,
+
+		// Alternating lengths of disabled and enabled runs, starting with a (possibly empty) disabled run.
+		run_length
+	};
+
+	/*
+		Fixed-size atomic bitset which compresses pages that haven't been accessed recently.
+
+		Time is divided into epochs (see `advance_epoch`). Pages which haven't been accessed for a given number of epochs
+		are replaced with a compressed encoding by `compress_cold_pages` (either called directly, or by a background sweeper;
+		see `start_sweeper`). The next access to a compressed page expands it back into a resident page, with the exception of
+		reads from all-zero and all-one pages, which are answered without expanding them. Every page starts out as all-zero,
+		so no memory is held for pages which are never written.
+
+		Each page has an atomic state word holding its tier and the number of writes in flight on it. Writes to resident
+		pages never block one another, while a page is only compressed once it has no writers, and operations wait for
+		a page being expanded (or compressed) to be reinstalled.
+
+		Reads of resident pages don't touch the page's state at all. A reader registers itself on a per-thread stripe of
+		counters, then loads the page's published words; compression unpublishes a page's words before they're freed,
+		and only frees them once every reader which might still be using them has finished (see `synchronize_readers`).
+	*/
+	template
+	<
+		// Specifies the underlying integral type used to store binary data.
+		typename T,
+
+		// Controls the number of elements allocated for each page of memory.
+		std::size_t fixed_page_size
+	>
+	class basic_tiered_atomic_bitset
+	{
+		public:
+			using underlying_type = T;
+
+			using atomic_type  = std::atomic<underlying_type>;
+			using element_type = atomic_type;
+			using page_type    = fixed_size_atomic_page<underlying_type, fixed_page_size, element_type>;
+
+			using value_type = bool;
+
+			using size_t = std::size_t;
+
+			using index_t      = size_t;
+			using page_index_t = size_t;
+			using epoch_t      = std::uint64_t;
+			using state_type   = std::uint64_t;
+
+			inline static constexpr size_t page_size = static_cast<size_t>(fixed_page_size);
+
+			inline static constexpr size_t bits_per_byte = 8;
+			inline static constexpr size_t bit_stride    = (sizeof(underlying_type) * bits_per_byte);
+			inline static constexpr size_t page_stride   = (static_cast<size_t>(page_size) * bit_stride);
+
+			// Bit positions (and run lengths) within a page.
+			using position_type = std::conditional_t<(page_stride <= std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::uint32_t>;
+
+			// Pages are only compressed if their encoding takes at most this many bytes.
+			inline static constexpr size_t max_encoded_size = (page_type::page_size_in_memory / 4);
+
+			// The number of counter stripes readers are spread across (see `read_guard`).
+			inline static constexpr size_t reader_stripe_count = 32;
+
+			// Page states: [63] transitioning flag, [62..56] tier, [55..0] operations in flight.
+			inline static constexpr state_type tier_shift      = 56;
+			inline static constexpr state_type user_mask       = ((static_cast<state_type>(1) << tier_shift) - static_cast<state_type>(1));
+			inline static constexpr state_type transition_flag = (static_cast<state_type>(1) << 63);
+
+			// Memory held by the pages of a single tier.
+			struct tier_usage
+			{
+				size_t pages = {};
+				size_t bytes = {};
+			};
+
+			// Memory held by the bitset's pages, per tier (see `memory_usage`).
+			struct memory_usage_type
+			{
+				tier_usage resident;
+				tier_usage all_zero;
+				tier_usage all_one;
+				tier_usage sparse;
+				tier_usage run_length;
+
+				size_t total_bytes() const
+				{
+					return (resident.bytes + all_zero.bytes + all_one.bytes + sparse.bytes + run_length.bytes);
+				}
+			};
+
+			explicit basic_tiered_atomic_bitset(size_t size_in_bits) :
+				size_in_bits(size_in_bits),
+				slots(((size_in_bits + (page_stride - static_cast<size_t>(1))) / page_stride))
+			{}
+
+			basic_tiered_atomic_bitset(const basic_tiered_atomic_bitset&) = delete;
+			basic_tiered_atomic_bitset& operator=(const basic_tiered_atomic_bitset&) = delete;
+
+			static constexpr page_index_t resolve_page_index(index_t index)
+			{
+				return static_cast<page_index_t>(index / static_cast<index_t>(page_stride));
+			}
+
+			static constexpr size_t resolve_element_index(index_t index)
+			{
+				return static_cast<size_t>((index / static_cast<index_t>(bit_stride)) % static_cast<index_t>(page_size));
+			}
+
+			static constexpr size_t resolve_bit_offset_from_index(index_t index)
+			{
+				return static_cast<size_t>(index % static_cast<index_t>(bit_stride));
+			}
+
+			value_type get(index_t index) const
+			{
+				if (index >= size())
+				{
+					return {};
+				}
+
+				const auto page_index = resolve_page_index(index);
+
+				auto& slot = slots[page_index];
+
+				{
+					const auto guard = read_guard { *this };
+
+					if (const auto* words = slot.words.load())
+					{
+						touch_page(slot);
+
+						return static_cast<value_type>(impl::get_bit(words[resolve_element_index(index)], resolve_bit_offset_from_index(index)));
+					}
+				}
+
+				// Uniform pages can be read straight from their state.
+				const auto state = slot.state.load();
+
+				if ((state & transition_flag) == state_type {})
+				{
+					switch (get_state_tier(state))
+					{
+						case page_tier::all_zero:
+							return false;
+						case page_tier::all_one:
+							return true;
+
+						default:
+							break;
+					}
+				}
+
+				const auto* words = acquire_page(page_index);
+				const auto result = static_cast<value_type>(impl::get_bit(words[resolve_element_index(index)], resolve_bit_offset_from_index(index)));
+
+				release_page(page_index);
+
+				return result;
+			}
+
+			underlying_type set(index_t index, value_type value)
+			{
+				return update_element
+				(
+					index,
+
+					[value](element_type& element, size_t bit_offset)
+					{
+						return impl::set_bit(element, bit_offset, value);
+					}
+				);
+			}
+
+			underlying_type enable(index_t index)
+			{
+				return update_element
+				(
+					index,
+
+					[](element_type& element, size_t bit_offset)
+					{
+						return impl::enable_bit(element, bit_offset);
+					}
+				);
+			}
+
+			underlying_type disable(index_t index)
+			{
+				return update_element
+				(
+					index,
+
+					[](element_type& element, size_t bit_offset)
+					{
+						return impl::disable_bit(element, bit_offset);
+					}
+				);
+			}
+
+			underlying_type toggle(index_t index)
+			{
+				return update_element
+				(
+					index,
+
+					[](element_type& element, size_t bit_offset)
+					{
+						return impl::toggle_bit(element, bit_offset);
+					}
+				);
+			}
+
+			value_type operator[](index_t index) const
+			{
+				return get(index);
+			}
+
+			bool empty() const
+			{
+				return (size() == 0);
+			}
+
+			size_t size() const
+			{
+				return size_in_bits;
+			}
+
+			size_t page_count() const
+			{
+				return slots.size();
+			}
+
+			// The current representation of `page_index`. Pages in the middle of a transition report their previous tier.
+			page_tier get_page_tier(page_index_t page_index) const
+			{
+				return get_state_tier(slots[page_index].state.load());
+			}
+
+			epoch_t epoch() const
+			{
+				return current_epoch.load();
+			}
+
+			// Begins a new epoch, returning its number. Pages accessed during an epoch are considered warm for `min_idle_epochs` after it.
+			epoch_t advance_epoch()
+			{
+				return (current_epoch.fetch_add(1) + static_cast<epoch_t>(1));
+			}
+
+			/*
+				Compresses every resident page which hasn't been accessed for at least `min_idle_epochs` epochs,
+				and which isn't currently in use. Pages whose contents don't compress well enough stay resident.
+
+				Returns the number of pages compressed.
+			*/
+			size_t compress_cold_pages(epoch_t min_idle_epochs)
+			{
+				auto compressed_pages = size_t {};
+
+				// Pages whose words have been unpublished, but which readers may still be using.
+				auto retired_pages = std::vector<page_type> {};
+
+				for (auto page_index = page_index_t {}; page_index < page_count(); page_index++)
+				{
+					compressed_pages += static_cast<size_t>(try_compress_page(page_index, min_idle_epochs, retired_pages));
+				}
+
+				if (!retired_pages.empty())
+				{
+					synchronize_readers();
+				}
+
+				return compressed_pages;
+			}
+
+			/*
+				Starts a background thread which advances the epoch every `epoch_length`,
+				compressing pages left idle for `min_idle_epochs` after each advance. Has no effect if it's already running.
+			*/
+			void start_sweeper(std::chrono::milliseconds epoch_length, epoch_t min_idle_epochs)
+			{
+				auto sweeper_lock = std::scoped_lock { sweeper_mutex };
+
+				if (sweeper.joinable())
+				{
+					return;
+				}
+
+				sweeper = std::jthread
+				{
+					[this, epoch_length, min_idle_epochs](std::stop_token stop_token)
+					{
+						auto wait_mutex = std::mutex {};
+						auto wait_condition = std::condition_variable_any {};
+
+						auto wait_lock = std::unique_lock { wait_mutex };
+
+						while (!wait_condition.wait_for(wait_lock, stop_token, epoch_length, [&stop_token]() { return stop_token.stop_requested(); }))
+						{
+							advance_epoch();
+							compress_cold_pages(min_idle_epochs);
+						}
+					}
+				};
+			}
+
+			// Stops the background sweeper (if any), waiting for it to exit.
+			void stop_sweeper()
+			{
+				auto stopped_sweeper = std::jthread {};
+
+				{
+					auto sweeper_lock = std::scoped_lock { sweeper_mutex };
+
+					stopped_sweeper = std::move(sweeper);
+				}
+
+				// Destroying the thread requests a stop (waking it) and joins it.
+			}
+
+			// Reports the number of pages and bytes of page storage held by each tier.
+			memory_usage_type memory_usage() const
+			{
+				auto result = memory_usage_type {};
+
+				for (const auto& slot : slots)
+				{
+					const auto state = slot.state.load();
+
+					auto& usage = [&result](page_tier tier) -> tier_usage&
+					{
+						switch (tier)
+						{
+							case page_tier::all_zero:
+								return result.all_zero;
+							case page_tier::all_one:
+								return result.all_one;
+							case page_tier::sparse:
+								return result.sparse;
+							case page_tier::run_length:
+								return result.run_length;
+
+							default:
+								return result.resident;
+						}
+					}(get_state_tier(state));
+
+					usage.pages++;
+					usage.bytes += slot.stored_bytes.load(std::memory_order_relaxed);
+				}
+
+				return result;
+			}
+
+		protected:
+			struct alignas(64) slot_type
+			{
+				std::atomic<state_type> state = { make_state(page_tier::all_zero) };
+
+				// The resident page's words, or null if the page isn't resident.
+				std::atomic<element_type*> words = { nullptr };
+
+				// The last epoch in which the page was accessed.
+				std::atomic<epoch_t> last_access_epoch = { epoch_t {} };
+
+				// The number of bytes held by the page in its current tier (for `memory_usage`).
+				std::atomic<size_t> stored_bytes = { size_t {} };
+
+				// Only accessed by the thread transitioning the page, or (for `page`) by users of a resident page.
+				std::optional<page_type> page;
+				std::vector<position_type> encoding;
+			};
+
+			// A padded reader counter; see `read_guard`.
+			struct alignas(64) reader_counter
+			{
+				std::atomic<size_t> value = { size_t {} };
+			};
+
+			/*
+				Registers the calling thread as a reader of resident pages' words for as long as the guard lives.
+
+				Readers increment a counter chosen by their thread (so hot pages aren't shared between readers' caches),
+				in one of two sets selected by the current reader phase. `synchronize_readers` flips the phase,
+				then waits for the previous set's counters to drain.
+			*/
+			class read_guard
+			{
+				public:
+					explicit read_guard(const basic_tiered_atomic_bitset& target_bitset)
+					{
+						const auto stripe = get_reader_stripe();
+
+						// Retry if the phase flipped before registering, so that the next flip is sure to wait for this reader.
+						while (true)
+						{
+							const auto phase = target_bitset.reader_phase.load();
+
+							counter = &(target_bitset.reader_counters[phase][stripe].value);
+
+							counter->fetch_add(1);
+
+							if (target_bitset.reader_phase.load() == phase)
+							{
+								break;
+							}
+
+							counter->fetch_sub(1);
+						}
+					}
+
+					~read_guard()
+					{
+						counter->fetch_sub(1);
+					}
+
+					read_guard(const read_guard&) = delete;
+					read_guard& operator=(const read_guard&) = delete;
+
+				private:
+					std::atomic<size_t>* counter = nullptr;
+			};
+
+			static size_t get_reader_stripe()
+			{
+				static thread_local const auto stripe = (std::hash<std::thread::id> {}(std::this_thread::get_id()) % reader_stripe_count);
+
+				return stripe;
+			}
+
+			/*
+				Waits until every reader which may have loaded words unpublished before this call has finished with them.
+				Readers registered afterward see the words as unpublished.
+			*/
+			void synchronize_readers()
+			{
+				auto reclaim_lock = std::scoped_lock { reclaim_mutex };
+
+				const auto previous_phase = reader_phase.load();
+
+				reader_phase.store((previous_phase ^ static_cast<size_t>(1)));
+
+				for (const auto& counter : reader_counters[previous_phase])
+				{
+					while (counter.value.load() != size_t {})
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+
+			static constexpr state_type make_state(page_tier tier)
+			{
+				return (static_cast<state_type>(tier) << tier_shift);
+			}
+
+			static constexpr page_tier get_state_tier(state_type state)
+			{
+				return static_cast<page_tier>((state & ~transition_flag) >> tier_shift);
+			}
+
+			template <typename Operation>
+			underlying_type update_element(index_t index, Operation&& operation)
+			{
+				assert(index < size());
+
+				const auto page_index = resolve_page_index(index);
+
+				auto* words = acquire_page(page_index);
+
+				const auto previous_value = operation(words[resolve_element_index(index)], resolve_bit_offset_from_index(index));
+
+				release_page(page_index);
+
+				return previous_value;
+			}
+
+			// Registers an operation on `page_index`, expanding the page first if it's compressed. Returns the page's words.
+			element_type* acquire_page(page_index_t page_index) const
+			{
+				auto& slot = slots[page_index];
+
+				auto current_state = slot.state.load();
+
+				while (true)
+				{
+					if ((current_state & transition_flag) != state_type {})
+					{
+						std::this_thread::yield();
+
+						current_state = slot.state.load();
+
+						continue;
+					}
+
+					const auto tier = get_state_tier(current_state);
+
+					if (tier == page_tier::resident)
+					{
+						assert((current_state & user_mask) != user_mask);
+
+						if (slot.state.compare_exchange_weak(current_state, (current_state + static_cast<state_type>(1))))
+						{
+							break;
+						}
+
+						continue;
+					}
+
+					// Compressed pages never have users, so the slot can be claimed outright.
+					if (slot.state.compare_exchange_weak(current_state, (current_state | transition_flag)))
+					{
+						expand_page(slot, tier);
+
+						// Reinstall the page with this operation already registered.
+						slot.state.store((make_state(page_tier::resident) + static_cast<state_type>(1)), std::memory_order_release);
+
+						break;
+					}
+				}
+
+				touch_page(slot);
+
+				return slot.page->data();
+			}
+
+			void release_page(page_index_t page_index) const
+			{
+				slots[page_index].state.fetch_sub(static_cast<state_type>(1));
+			}
+
+			void touch_page(slot_type& slot) const
+			{
+				const auto epoch = current_epoch.load(std::memory_order_relaxed);
+
+				// Avoid writing to the slot's cache line when the page has already been touched this epoch.
+				if (slot.last_access_epoch.load(std::memory_order_relaxed) != epoch)
+				{
+					slot.last_access_epoch.store(epoch, std::memory_order_relaxed);
+				}
+			}
+
+			// Compresses `page_index` if it's idle, moving its memory to `retired_pages` (see `synchronize_readers`).
+			bool try_compress_page(page_index_t page_index, epoch_t min_idle_epochs, std::vector<page_type>& retired_pages)
+			{
+				auto& slot = slots[page_index];
+
+				const auto is_idle = [this, &slot, min_idle_epochs]()
+				{
+					return ((current_epoch.load() - slot.last_access_epoch.load()) >= min_idle_epochs);
+				};
+
+				if (!is_idle())
+				{
+					return false;
+				}
+
+				auto expected_state = make_state(page_tier::resident);
+
+				if (!slot.state.compare_exchange_strong(expected_state, (expected_state | transition_flag)))
+				{
+					return false;
+				}
+
+				// The page may have been used between the first check and claiming it.
+				const auto tier = (is_idle())
+					? encode_page(slot)
+					: page_tier::resident
+				;
+
+				if (tier != page_tier::resident)
+				{
+					// Readers may still hold the words, so they're only released once they've finished.
+					slot.words.store(nullptr);
+
+					retired_pages.push_back(std::move(*slot.page));
+
+					slot.page.reset();
+
+					slot.encoding.shrink_to_fit();
+					slot.stored_bytes.store((slot.encoding.capacity() * sizeof(position_type)), std::memory_order_relaxed);
+				}
+
+				slot.state.store(make_state(tier), std::memory_order_release);
+
+				return (tier != page_tier::resident);
+			}
+
+			// Chooses the smallest encoding of `slot`'s page, storing it in `slot.encoding`. Returns `page_tier::resident` if none is small enough.
+			static page_tier encode_page(slot_type& slot)
+			{
+				constexpr auto max_positions = (max_encoded_size / sizeof(position_type));
+
+				const auto* words = slot.page->data();
+
+				auto population = size_t {};
+
+				for (auto element_index = size_t {}; element_index < page_size; element_index++)
+				{
+					population += static_cast<size_t>(std::popcount(words[element_index].load(std::memory_order_relaxed)));
+				}
+
+				if (population == 0)
+				{
+					return page_tier::all_zero;
+				}
+
+				if (population == page_stride)
+				{
+					return page_tier::all_one;
+				}
+
+				auto runs = std::vector<position_type> {};
+
+				if (encode_runs(words, runs, max_positions) && (runs.size() < population))
+				{
+					slot.encoding = std::move(runs);
+
+					return page_tier::run_length;
+				}
+
+				if (population > max_positions)
+				{
+					return page_tier::resident;
+				}
+
+				slot.encoding.clear();
+				slot.encoding.reserve(population);
+
+				for (auto element_index = size_t {}; element_index < page_size; element_index++)
+				{
+					auto word = words[element_index].load(std::memory_order_relaxed);
+
+					while (word != underlying_type {})
+					{
+						slot.encoding.push_back(static_cast<position_type>((element_index * bit_stride) + static_cast<size_t>(std::countr_zero(word))));
+
+						word &= static_cast<underlying_type>(word - static_cast<underlying_type>(1));
+					}
+				}
+
+				return page_tier::sparse;
+			}
+
+			// Encodes the lengths of alternating runs of disabled and enabled bits. Returns false if more than `max_runs` would be needed.
+			static bool encode_runs(const element_type* words, std::vector<position_type>& runs, size_t max_runs)
+			{
+				auto run_value = false;
+				auto run_start = size_t {};
+
+				for (auto position = size_t {}; position < page_stride; )
+				{
+					const auto element_index = (position / bit_stride);
+					const auto bit_offset = (position % bit_stride);
+
+					const auto word = words[element_index].load(std::memory_order_relaxed);
+
+					// Bits which end the current run, from `position` onward.
+					const auto boundaries = static_cast<underlying_type>(static_cast<underlying_type>((run_value) ? ~word : word) >> bit_offset);
+
+					if (boundaries == underlying_type {})
+					{
+						position = ((element_index + static_cast<size_t>(1)) * bit_stride);
+
+						continue;
+					}
+
+					position += static_cast<size_t>(std::countr_zero(boundaries));
+
+					if (runs.size() == max_runs)
+					{
+						return false;
+					}
+
+					runs.push_back(static_cast<position_type>(position - run_start));
+
+					run_start = position;
+					run_value = (!run_value);
+				}
+
+				if (runs.size() == max_runs)
+				{
+					return false;
+				}
+
+				runs.push_back(static_cast<position_type>(page_stride - run_start));
+
+				return true;
+			}
+
+			// Rebuilds a resident page from `slot`'s encoding. The caller must hold the slot's transition flag.
+			static void expand_page(slot_type& slot, page_tier tier)
+			{
+				switch (tier)
+				{
+					case page_tier::all_one:
+						slot.page.emplace(static_cast<underlying_type>(~underlying_type {}));
+
+						break;
+
+					case page_tier::sparse:
+					{
+						slot.page.emplace(underlying_type {});
+
+						auto* words = slot.page->data();
+
+						for (const auto position : slot.encoding)
+						{
+							auto& element = words[(position / bit_stride)];
+
+							element.store(static_cast<underlying_type>(element.load(std::memory_order_relaxed) | static_cast<underlying_type>(static_cast<underlying_type>(1) << (position % bit_stride))), std::memory_order_relaxed);
+						}
+
+						break;
+					}
+
+					case page_tier::run_length:
+					{
+						slot.page.emplace(underlying_type {});
+
+						auto* words = slot.page->data();
+
+						auto position = size_t {};
+						auto run_value = false;
+
+						for (const auto run_length : slot.encoding)
+						{
+							if (run_value)
+							{
+								enable_range(words, position, (position + static_cast<size_t>(run_length)));
+							}
+
+							position += static_cast<size_t>(run_length);
+							run_value = (!run_value);
+						}
+
+						break;
+					}
+
+					default:
+						slot.page.emplace(underlying_type {});
+
+						break;
+				}
+
+				slot.encoding = {};
+				slot.stored_bytes.store(page_type::page_size_in_memory, std::memory_order_relaxed);
+
+				slot.words.store(slot.page->data());
+			}
+
+			static void enable_range(element_type* words, size_t begin, size_t end)
+			{
+				for (auto position = begin; position < end; )
+				{
+					const auto bit_offset = (position % bit_stride);
+					const auto bit_count = std::min((bit_stride - bit_offset), (end - position));
+
+					auto& element = words[(position / bit_stride)];
+
+					element.store(static_cast<underlying_type>(element.load(std::memory_order_relaxed) | impl::make_bit_range_mask<underlying_type>(bit_offset, bit_count)), std::memory_order_relaxed);
+
+					position += bit_count;
+				}
+			}
+
+			size_t size_in_bits;
+
+			std::atomic<epoch_t> current_epoch = { epoch_t {} };
+
+			// Reads may expand pages, so the slots are mutable.
+			mutable std::vector<slot_type> slots;
+
+			// Reader registrations, by phase and stripe (see `read_guard`).
+			mutable std::array<std::array<reader_counter, reader_stripe_count>, 2> reader_counters = {};
+
+			std::atomic<size_t> reader_phase = { size_t {} };
+
+		private:
+			// Serializes grace periods between concurrent calls to `compress_cold_pages`.
+			std::mutex reclaim_mutex;
+
+			std::mutex sweeper_mutex;
+
+			// Declared last, so that the sweeper is stopped before anything it uses is destroyed.
+			std::jthread sweeper;
+	};
+
+	// Defaults to 64-bit unsigned integers: 512 x 8 x 8 (4096 bytes, 32768 bits)
+	using tiered_atomic_bitset = basic_tiered_atomic_bitset<std::uint64_t, 512>;
+}
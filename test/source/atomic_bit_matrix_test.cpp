@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/atomic_bit_matrix.hpp>
+#include <immutableoctet/atomic_bitset/atomic_bitset.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::atomic_bit_matrix", "[atomic-bit-matrix]")
+{
+	using matrix_t = immutableoctet::atomic_bit_matrix;
+	using bitset_t = immutableoctet::atomic_bitset;
+
+	SECTION("Row and column operations")
+	{
+		auto matrix = matrix_t { 100, 1000 };
+
+		REQUIRE(matrix.words_per_row() == 16);
+
+		matrix.enable(3, 0);
+		matrix.enable(3, 999);
+		matrix.enable(4, 999);
+		matrix.enable(4, 500);
+
+		REQUIRE(matrix.get(3, 999));
+		REQUIRE(!matrix.get(3, 500));
+
+		matrix.row_or(5, 3);
+		matrix.row_or(5, 4);
+
+		REQUIRE(matrix.row_population(5) == 3);
+
+		matrix.row_and(5, 4);
+
+		REQUIRE(matrix.row_population(5) == 2);
+		REQUIRE(!matrix.get(5, 0));
+
+		REQUIRE(matrix.column_population(999) == 3);
+
+		auto rows = std::vector<std::size_t> {};
+
+		matrix.for_each_in_column(999, [&rows](std::size_t row) { rows.push_back(row); });
+
+		REQUIRE(rows == std::vector<std::size_t> { 3, 4, 5 });
+	}
+
+	SECTION("Breadth-first search")
+	{
+		// A ring of 2000 vertices, which spans several pages of the matrix.
+		constexpr std::size_t n_vertices = 2000;
+
+		auto matrix = matrix_t { n_vertices, n_vertices };
+
+		for (std::size_t vertex = 0; vertex < n_vertices; vertex++)
+		{
+			matrix.enable(vertex, ((vertex + 1) % n_vertices));
+			matrix.enable(((vertex + 1) % n_vertices), vertex);
+		}
+
+		auto visited = bitset_t {};
+		auto frontier = bitset_t {};
+
+		visited.resize(n_vertices);
+		frontier.resize(n_vertices);
+
+		visited.enable(0);
+		frontier.enable(0);
+
+		std::size_t depth = 0;
+		std::size_t reached = 1;
+
+		while (reached < n_vertices)
+		{
+			auto next = bitset_t {};
+
+			next.resize(n_vertices);
+
+			std::size_t discovered = 0;
+
+			if ((depth % 2) == 0)
+			{
+				std::size_t first_half = 0;
+				std::size_t second_half = 0;
+
+				{
+					auto first = std::jthread { [&] { first_half = matrix.expand_frontier(frontier, visited, next, 0, (n_vertices / 2)); } };
+					auto second = std::jthread { [&] { second_half = matrix.expand_frontier(frontier, visited, next, (n_vertices / 2), n_vertices); } };
+				}
+
+				discovered = (first_half + second_half);
+			}
+			else
+			{
+				discovered = matrix.expand_frontier_bottom_up(frontier, visited, next);
+			}
+
+			REQUIRE(discovered > 0);
+
+			for (std::size_t vertex = 0; vertex < n_vertices; vertex++)
+			{
+				if (next.get(vertex))
+				{
+					visited.enable(vertex);
+				}
+			}
+
+			reached += discovered;
+			depth++;
+
+			frontier.resize(0);
+			frontier.resize(n_vertices);
+
+			for (std::size_t vertex = 0; vertex < n_vertices; vertex++)
+			{
+				frontier.set(vertex, next.get(vertex));
+			}
+		}
+
+		REQUIRE(reached == n_vertices);
+		REQUIRE(depth == (n_vertices / 2));
+	}
+}
@@ -3,6 +3,10 @@
 #include <immutableoctet/atomic_bitset/atomic_bitset.hpp>
 
 #include <thread>
+#include <vector>
+#include <array>
+#include <span>
+#include <algorithm>
 
 #include <cstddef>
 #include <cstdint>
@@ -92,4 +96,444 @@ TEST_CASE("immutableoctet::atomic_bitset", "[atomic-bitset]")
 
 		REQUIRE(sum_of_bits == n_elements);
 	}
+
+	SECTION("Multi-bit masks")
+	{
+		using mask_bitset_t = immutableoctet::atomic_bitset;
+
+		auto bitset = mask_bitset_t {};
+
+		bitset.resize(256);
+
+		REQUIRE(bitset.compare_and_set_mask(0, 0b1111));
+		REQUIRE(!bitset.compare_and_set_mask(0, 0b1000));
+		REQUIRE(bitset.fetch_and_mask(0, ~std::uint64_t { 0b0011 }) == 0b1111);
+		REQUIRE(bitset.fetch_or_mask(0, 0b0001) == 0b1100);
+
+		const auto first_run = bitset.try_acquire_run(100);
+
+		REQUIRE(first_run.has_value());
+		REQUIRE(*first_run == 4);
+		REQUIRE(bitset[3]);
+		REQUIRE(bitset[103]);
+		REQUIRE(!bitset[104]);
+
+		REQUIRE(!bitset.try_acquire_run(200).has_value());
+
+		const auto second_run = bitset.try_acquire_run(150);
+
+		REQUIRE(second_run.has_value());
+		REQUIRE(*second_run == 104);
+
+		bitset.release_run(*first_run, 100);
+
+		REQUIRE(!bitset[4]);
+		REQUIRE(!bitset[103]);
+		REQUIRE(bitset[104]);
+		REQUIRE(bitset.try_acquire_run(100) == first_run);
+	}
+
+	SECTION("Delta replication")
+	{
+		using tracked_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, 0, true, true>;
+
+		auto source = tracked_bitset_t {};
+		auto replica = tracked_bitset_t {};
+
+		source[5] = true;
+		source.speculative_enable(40000);
+		source.speculative_enable(40001);
+
+		auto delta = source.collect_delta();
+
+		REQUIRE(delta.size_in_bits == 40002);
+		REQUIRE(delta.runs.size() == 2);
+		REQUIRE(delta.runs[0].page_index == 0);
+		REQUIRE(delta.runs[1].page_index == 1);
+
+		replica.apply_delta(delta);
+
+		REQUIRE(replica.size() == source.size());
+		REQUIRE(replica[5]);
+		REQUIRE(replica[40000]);
+		REQUIRE(replica[40001]);
+		REQUIRE(!replica[6]);
+
+		// Nothing changed since the last collection.
+		REQUIRE(source.collect_delta().runs.empty());
+
+		// Rewriting a bit with its current value isn't a change.
+		source[5] = true;
+		source[40000] = false;
+
+		delta = source.collect_delta();
+
+		REQUIRE(delta.runs.size() == 1);
+		REQUIRE(delta.runs[0].words.size() == tracked_bitset_t::dirty_block_size);
+
+		replica.apply_delta(delta);
+
+		REQUIRE(!replica[40000]);
+		REQUIRE(replica[40001]);
+
+		// Writes which grow the bitset are marked while other threads are writing to existing pages.
+		{
+			auto work = [&source](std::size_t offset)
+			{
+				for (std::size_t page_index = 0; page_index < 64; page_index++)
+				{
+					source.speculative_enable(((page_index * tracked_bitset_t::page_stride) + offset));
+				}
+			};
+
+			auto first = std::jthread { work, 7 };
+			auto second = std::jthread { work, 9 };
+		}
+
+		replica.apply_delta(source.collect_delta());
+
+		for (std::size_t page_index = 0; page_index < 64; page_index++)
+		{
+			REQUIRE(replica[((page_index * tracked_bitset_t::page_stride) + 7)]);
+			REQUIRE(replica[((page_index * tracked_bitset_t::page_stride) + 9)]);
+		}
+	}
+
+	SECTION("Exclusive bulk access")
+	{
+		using tracked_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, 0, true, true>;
+
+		auto bitset = tracked_bitset_t {};
+
+		{
+			auto view = bitset.lock_for_bulk();
+
+			view.resize(100000);
+			view.fill(10, 70000, true);
+			view.disable(500);
+
+			REQUIRE(view.get(10));
+			REQUIRE(!view.get(500));
+
+			auto* words = view.page_data(2);
+
+			REQUIRE(words);
+
+			words[0] = 0b101;
+		}
+
+		REQUIRE(!bitset[9]);
+		REQUIRE(bitset[10]);
+		REQUIRE(!bitset[500]);
+		REQUIRE(bitset[69999]);
+		REQUIRE(!bitset[70000]);
+		REQUIRE(bitset[(tracked_bitset_t::page_stride * 2) + 2]);
+		REQUIRE(!bitset[(tracked_bitset_t::page_stride * 2) + 1]);
+
+		// Pages handed out as plain memory are treated as entirely dirty.
+		const auto delta = bitset.collect_delta();
+
+		REQUIRE(delta.runs.size() == 3);
+		REQUIRE(delta.runs.back().words.size() == tracked_bitset_t::page_size);
+	}
+
+	SECTION("Population tracking")
+	{
+		using counted_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, 0, true, false, true>;
+
+		constexpr auto bit_count = ((counted_bitset_t::page_stride * 3) + 100);
+
+		auto counted = counted_bitset_t {};
+		auto scanned = immutableoctet::atomic_bitset {};
+
+		counted.resize(bit_count);
+		scanned.resize(bit_count);
+
+		{
+			auto work = [&counted](std::size_t stride, std::size_t offset)
+			{
+				for (std::size_t index = offset; index < bit_count; index += stride)
+				{
+					counted.enable(index);
+				}
+			};
+
+			auto first = std::jthread { work, 3, 0 };
+			auto second = std::jthread { work, 3, 1 };
+		}
+
+		for (std::size_t index = 0; index < bit_count; index += 3)
+		{
+			scanned.enable(index);
+			scanned.enable((index + 1));
+		}
+
+		for (std::size_t index = 0; index < bit_count; index += 5)
+		{
+			counted.toggle(index);
+			scanned.toggle(index);
+		}
+
+		counted.enable(1);
+		counted[2] = false;
+		scanned[2] = false;
+
+		REQUIRE(counted.count() == scanned.count());
+		REQUIRE(counted.page_population(0) == scanned.page_population(0));
+
+		// Bits beyond the end of the bitset aren't counted.
+		counted.resize(100);
+		scanned.resize(100);
+
+		REQUIRE(counted.count() == scanned.count());
+
+		counted.resize((counted_bitset_t::page_stride - 100));
+		scanned.resize((counted_bitset_t::page_stride - 100));
+
+		REQUIRE(counted.count() == scanned.count());
+
+		// Bulk writes are recounted once released.
+		{
+			auto view = counted.lock_for_bulk();
+
+			view.fill(0, counted_bitset_t::page_stride, false);
+		}
+
+		REQUIRE(counted.count() == 0);
+
+		// Pages start out with the population of their default value.
+		using filled_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, std::numeric_limits<std::uint64_t>::max(), true, false, true>;
+
+		auto filled = filled_bitset_t {};
+
+		filled.resize((filled_bitset_t::page_stride + 10));
+
+		REQUIRE(filled.count() == (filled_bitset_t::page_stride + 10));
+
+		filled.disable(3);
+
+		REQUIRE(filled.page_population(0) == (filled_bitset_t::page_stride - 1));
+		REQUIRE(filled.try_acquire_run(1) == 3);
+		REQUIRE(filled.count() == (filled_bitset_t::page_stride + 10));
+
+		// Counters for new pages are in place before other threads can write to them.
+		auto growing = counted_bitset_t {};
+
+		{
+			auto work = [&growing](std::size_t offset)
+			{
+				for (std::size_t page_index = 0; page_index < 64; page_index++)
+				{
+					growing.speculative_enable(((page_index * counted_bitset_t::page_stride) + offset));
+				}
+			};
+
+			auto first = std::jthread { work, 7 };
+			auto second = std::jthread { work, 9 };
+		}
+
+		REQUIRE(growing.count() == 128);
+	}
+
+	SECTION("Page preallocation")
+	{
+		using preallocated_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, 0, true, false, false, true>;
+
+		constexpr auto page_stride = preallocated_bitset_t::page_stride;
+
+		auto bitset = preallocated_bitset_t {};
+
+		bitset.set_spare_page_target(4);
+
+		REQUIRE(bitset.refill_spare_pages() == 4);
+		REQUIRE(bitset.spare_page_count() == 4);
+
+		bitset.resize((page_stride * 3));
+
+		REQUIRE(bitset.spare_page_count() == 1);
+		REQUIRE(bitset.get_page_pool_stats().hits == 3);
+		REQUIRE(!bitset.get((page_stride * 2) + 5));
+
+		bitset.start_page_preallocator();
+
+		while (bitset.spare_page_count() < 4)
+		{
+			std::this_thread::yield();
+		}
+
+		bitset.stop_page_preallocator();
+
+		// Growth beyond the pool's contents falls back to allocating on the spot.
+		bitset.speculative_enable(((page_stride * 9) - 1));
+
+		const auto stats = bitset.get_page_pool_stats();
+
+		REQUIRE(stats.hits == 7);
+		REQUIRE(stats.misses == 2);
+		REQUIRE(stats.pages_preallocated == 7);
+
+		REQUIRE(bitset.spare_page_count() == 0);
+		REQUIRE(bitset.get(((page_stride * 9) - 1)));
+		REQUIRE(!bitset.get((page_stride * 5)));
+	}
+
+	SECTION("Index export")
+	{
+		auto bitset = immutableoctet::atomic_bitset {};
+
+		constexpr auto bit_count = std::size_t { 100000 };
+
+		bitset.resize(bit_count);
+
+		auto expected = std::vector<std::size_t> {};
+
+		// Mix of sparse, dense and full words.
+		for (std::size_t index = 0; index < bit_count; index++)
+		{
+			const auto word_index = (index / 64);
+
+			const bool value = ((word_index % 3) == 0)
+				? ((index % 17) == 0)
+				: ((word_index % 3) == 1)
+					? ((index % 3) != 0)
+					: true
+			;
+
+			if (value)
+			{
+				bitset.enable(index);
+				expected.push_back(index);
+			}
+		}
+
+		auto indices = std::vector<std::size_t>(bit_count);
+
+		const auto written = bitset.to_indices(indices);
+
+		REQUIRE(written == expected.size());
+		REQUIRE(std::equal(expected.begin(), expected.end(), indices.begin()));
+
+		// Ranges may start and end mid-word.
+		const auto range_written = bitset.to_indices_range(indices, 70, 1000);
+		const auto range_begin = std::lower_bound(expected.begin(), expected.end(), std::size_t { 70 });
+		const auto range_end = std::lower_bound(expected.begin(), expected.end(), std::size_t { 1000 });
+
+		REQUIRE(range_written == static_cast<std::size_t>(range_end - range_begin));
+		REQUIRE(std::equal(range_begin, range_end, indices.begin()));
+
+		// Small buffers resume where the previous batch left off.
+		auto buffer = std::array<std::size_t, 37> {};
+		auto exported = std::vector<std::size_t> {};
+
+		const auto total = bitset.for_each_index_batch
+		(
+			buffer,
+
+			[&exported](std::span<const std::size_t> batch)
+			{
+				exported.insert(exported.end(), batch.begin(), batch.end());
+			}
+		);
+
+		REQUIRE(total == expected.size());
+		REQUIRE(exported == expected);
+	}
+
+	SECTION("Batched lookups")
+	{
+		auto bitset = immutableoctet::atomic_bitset {};
+
+		constexpr auto bit_count = std::size_t { 200000 };
+
+		bitset.resize(bit_count);
+
+		for (std::size_t index = 0; index < bit_count; index += 7)
+		{
+			bitset.enable(index);
+		}
+
+		auto indices = std::vector<std::size_t> {};
+
+		// Scattered across pages, including indices beyond the end of the bitset.
+		for (std::size_t probe = 0; probe < 1000; probe++)
+		{
+			indices.push_back(((probe * 7919) % (bit_count + 5000)));
+		}
+
+		auto results = std::array<bool, 1000> {};
+		auto packed = std::vector<std::uint64_t>(((indices.size() + 63) / 64), ~std::uint64_t {});
+
+		bitset.get_many(indices, results);
+
+		const auto found = bitset.test_many(indices, packed);
+
+		auto expected_found = std::size_t {};
+
+		for (std::size_t probe = 0; probe < indices.size(); probe++)
+		{
+			const auto expected = bitset.get(indices[probe]);
+
+			expected_found += static_cast<std::size_t>(expected);
+
+			REQUIRE(results[probe] == expected);
+			REQUIRE((((packed[(probe / 64)] >> (probe % 64)) & 1) != 0) == expected);
+		}
+
+		REQUIRE(found == expected_found);
+	}
+
+	SECTION("Write combining")
+	{
+		using tracked_bitset_t = immutableoctet::basic_atomic_bitset<std::uint64_t, 512, 0, true, true, true>;
+
+		auto bitset = tracked_bitset_t {};
+
+		bitset.resize(100000);
+		bitset.enable(3);
+
+		{
+			auto writer = bitset.make_writer();
+
+			for (std::size_t index = 0; index < 64; index++)
+			{
+				writer.enable(index);
+			}
+
+			writer.disable(3);
+			writer.disable(70);
+			writer.enable(70);
+
+			REQUIRE(writer.pending_words() == 2);
+
+			// Nothing is visible until flushed.
+			REQUIRE(!bitset.get(0));
+			REQUIRE(bitset.get(3));
+
+			REQUIRE(writer.flush() == 2);
+			REQUIRE(writer.pending_words() == 0);
+
+			REQUIRE(bitset.get(0));
+			REQUIRE(!bitset.get(3));
+			REQUIRE(bitset.get(70));
+
+			// Filling the cache flushes it.
+			for (std::size_t word = 0; word <= tracked_bitset_t::writer_cache_size; word++)
+			{
+				writer.enable(((word * 64) + 1000));
+			}
+
+			REQUIRE(writer.pending_words() == 1);
+			REQUIRE(bitset.get(1000));
+
+			writer.disable(0);
+		}
+
+		// Destroying the writer flushes the rest.
+		REQUIRE(!bitset.get(0));
+		REQUIRE(bitset.get(((tracked_bitset_t::writer_cache_size * 64) + 1000)));
+
+		// Flushed writes are observed by change tracking.
+		REQUIRE(bitset.count() == (63 + 1 + tracked_bitset_t::writer_cache_size + 1 - 1));
+		REQUIRE(!bitset.collect_delta().runs.empty());
+	}
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/atomic_bloom_filter.hpp>
+
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::atomic_bloom_filter", "[atomic-bloom-filter]")
+{
+	using filter_t = immutableoctet::atomic_bloom_filter<std::uint64_t>;
+
+	constexpr std::size_t n_keys = 100000;
+
+	SECTION("No false negatives")
+	{
+		auto filter = filter_t { n_keys };
+
+		REQUIRE(filter.page_count() * filter_t::page_size >= filter.blocks());
+		REQUIRE(!filter.contains(1));
+
+		auto keys = std::vector<std::uint64_t> {};
+
+		for (std::uint64_t key = 0; key < n_keys; key++)
+		{
+			keys.push_back((key * 7919));
+		}
+
+		filter.insert_many(keys);
+
+		auto results = std::make_unique<bool[]>(n_keys);
+
+		filter.contains_many(keys, { results.get(), n_keys });
+
+		for (std::size_t key_index = 0; key_index < n_keys; key_index++)
+		{
+			REQUIRE(results[key_index]);
+		}
+
+		REQUIRE(filter.insert(keys.front()));
+
+		// Roughly 1% of absent keys should be reported as present at 10 bits per key.
+		std::size_t false_positives = 0;
+
+		for (std::uint64_t key = 0; key < n_keys; key++)
+		{
+			false_positives += static_cast<std::size_t>(filter.contains(((key * 7919) + 1)));
+		}
+
+		REQUIRE(false_positives < (n_keys / 20));
+
+		filter.clear();
+
+		REQUIRE(!filter.contains(keys.front()));
+	}
+
+	SECTION("Simultaneous insertion")
+	{
+		auto filter = filter_t { n_keys };
+
+		auto work = [&filter](std::uint64_t offset)
+		{
+			for (std::uint64_t key = offset; key < n_keys; key += 4)
+			{
+				filter.insert(key);
+			}
+		};
+
+		{
+			auto first = std::jthread { work, 0 };
+			auto second = std::jthread { work, 1 };
+			auto third = std::jthread { work, 2 };
+			auto fourth = std::jthread { work, 3 };
+		}
+
+		for (std::uint64_t key = 0; key < n_keys; key++)
+		{
+			REQUIRE(filter.contains(key));
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/atomic_packed_array.hpp>
+
+#include <thread>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::atomic_packed_array", "[atomic-packed-array]")
+{
+	SECTION("Field operations")
+	{
+		auto counters = immutableoctet::atomic_packed_array_4 { 100 };
+
+		REQUIRE(counters.size() == 100);
+		REQUIRE(counters.load(17) == 0);
+
+		REQUIRE(counters.store(17, 9) == 0);
+		REQUIRE(counters[17] == 9);
+		REQUIRE(counters[16] == 0);
+		REQUIRE(counters[18] == 0);
+
+		REQUIRE(counters.fetch_add_saturating(17, 10) == 9);
+		REQUIRE(counters[17] == 15);
+
+		REQUIRE(counters.fetch_sub_saturating(18) == 0);
+		REQUIRE(counters[18] == 0);
+
+		std::uint64_t expected = 3;
+
+		REQUIRE(!counters.compare_exchange(17, expected, 4));
+		REQUIRE(expected == 15);
+		REQUIRE(counters.compare_exchange(17, expected, 4));
+		REQUIRE(counters[17] == 4);
+
+		counters.request_index(1000);
+
+		REQUIRE(counters.size() == 1001);
+	}
+
+	SECTION("Bulk decay and histogram")
+	{
+		auto states = immutableoctet::atomic_packed_array_2 { 1000 };
+
+		for (std::size_t index = 0; index < states.size(); index++)
+		{
+			states.store(index, static_cast<std::uint64_t>(index % 4));
+		}
+
+		auto histogram = states.histogram();
+
+		REQUIRE(histogram[0] == 250);
+		REQUIRE(histogram[1] == 250);
+		REQUIRE(histogram[2] == 250);
+		REQUIRE(histogram[3] == 250);
+
+		states.decay_all();
+
+		histogram = states.histogram();
+
+		REQUIRE(histogram[0] == 500);
+		REQUIRE(histogram[1] == 500);
+		REQUIRE(histogram[2] == 0);
+		REQUIRE(states[3] == 1);
+
+		auto bytes = immutableoctet::atomic_packed_array_8 { 10 };
+
+		bytes.store(9, 200);
+
+		REQUIRE(bytes.histogram()[200] == 1);
+		REQUIRE(bytes.histogram()[0] == 9);
+	}
+
+	SECTION("Simultaneous saturating increments")
+	{
+		auto counters = immutableoctet::atomic_packed_array_4 { 64 };
+
+		auto work = [&counters]()
+		{
+			for (std::size_t round = 0; round < 5; round++)
+			{
+				for (std::size_t index = 0; index < counters.size(); index++)
+				{
+					counters.fetch_add_saturating(index);
+				}
+			}
+		};
+
+		{
+			auto first = std::jthread { work };
+			auto second = std::jthread { work };
+		}
+
+		REQUIRE(counters.histogram()[10] == 64);
+
+		{
+			auto first = std::jthread { work };
+			auto second = std::jthread { work };
+		}
+
+		REQUIRE(counters.histogram()[15] == 64);
+	}
+}
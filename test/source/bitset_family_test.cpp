@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/bitset_family.hpp>
+
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::bitset_family", "[bitset-family]")
+{
+	SECTION("Membership and predicates")
+	{
+		using family_t = immutableoctet::bitset_family<64>;
+
+		static_assert(family_t::words_per_id == 1);
+
+		auto family = family_t {};
+
+		constexpr std::size_t n_ids = 10000;
+
+		for (std::size_t id = 0; id < n_ids; id++)
+		{
+			if ((id % 2) == 0) { family.enable(0, id); }
+			if ((id % 3) == 0) { family.enable(1, id); }
+			if ((id % 5) == 0) { family.enable(63, id); }
+		}
+
+		REQUIRE(family.size() == n_ids);
+		REQUIRE(family.contains(0, 4));
+		REQUIRE(!family.contains(1, 4));
+
+		const auto membership = family.membership(30);
+
+		REQUIRE(membership[0] == family_t::make_mask({ 0, 1, 63 })[0]);
+
+		const auto required = family_t::make_mask({ 0, 1 });
+		const auto excluded = family_t::make_mask({ 63 });
+
+		REQUIRE(family.matches(6, required, excluded));
+		REQUIRE(!family.matches(30, required, excluded));
+
+		// Multiples of 6 which aren't multiples of 30.
+		REQUIRE(family.count_matching(0, n_ids, required, excluded) == (((n_ids + 5) / 6) - ((n_ids + 29) / 30)));
+
+		auto matching_ids = std::vector<std::size_t> {};
+
+		family.for_each_matching(0, 40, required, excluded, [&matching_ids](std::size_t id) { matching_ids.push_back(id); });
+
+		REQUIRE(matching_ids == std::vector<std::size_t> { 6, 12, 18, 24, 36 });
+
+		REQUIRE(family.disable(0, 6));
+		REQUIRE(!family.matches(6, required, excluded));
+	}
+
+	SECTION("Wide families")
+	{
+		using family_t = immutableoctet::bitset_family<100>;
+
+		static_assert(family_t::words_per_id == 2);
+
+		auto family = family_t {};
+
+		family.enable(99, 5000);
+		family.enable(3, 5000);
+
+		REQUIRE(family.size() == 5001);
+		REQUIRE(family.matches(5000, family_t::make_mask({ 3, 99 })));
+		REQUIRE(family.count_matching(0, family.size(), family_t::make_mask({ 99 })) == 1);
+		REQUIRE(family.count_matching(0, family.size(), {}, family_t::make_mask({ 99 })) == 5000);
+	}
+
+	SECTION("Default page size")
+	{
+		// Three words per ID don't divide 512-word pages evenly, so the default rounds down to whole IDs.
+		using family_t = immutableoctet::bitset_family<150>;
+
+		static_assert(family_t::words_per_id == 3);
+		static_assert(family_t::page_size == 510);
+
+		auto family = family_t {};
+
+		const auto last_id_of_page = ((family_t::page_size / family_t::words_per_id) - 1);
+
+		family.enable(149, last_id_of_page);
+		family.enable(0, (last_id_of_page + 1));
+
+		REQUIRE(family.contains(149, last_id_of_page));
+		REQUIRE(!family.contains(149, (last_id_of_page + 1)));
+		REQUIRE(family.contains(0, (last_id_of_page + 1)));
+		REQUIRE(family.membership(last_id_of_page) == family_t::make_mask({ 149 }));
+		REQUIRE(family.count_matching(0, family.size(), family_t::make_mask({ 0 })) == 1);
+	}
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/atomic_bitset.hpp>
+#include <immutableoctet/atomic_bitset/rank_select_index.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::rank_select_index", "[rank-select-index]")
+{
+	using bitset_t = immutableoctet::atomic_bitset;
+	using index_t = immutableoctet::basic_rank_select_index<bitset_t, 8, 64>;
+
+	auto bitset = bitset_t {};
+
+	const std::size_t n_bits = (bitset_t::page_stride * 3) + 1000;
+
+	bitset.resize(n_bits);
+
+	for (std::size_t index = 0; index < n_bits; index += 3)
+	{
+		bitset.enable(index);
+	}
+
+	SECTION("Rank and select")
+	{
+		auto index = index_t { bitset };
+
+		REQUIRE(index.count() == ((n_bits + 2) / 3));
+
+		for (std::size_t position = 0; position < n_bits; position += 97)
+		{
+			REQUIRE(index.rank(position) == ((position + 2) / 3));
+		}
+
+		for (std::size_t k = 0; k < index.count(); k += 101)
+		{
+			REQUIRE(index.select(k) == (k * 3));
+		}
+
+		REQUIRE(index.rank(n_bits) == index.count());
+		REQUIRE(!index.select(index.count()).has_value());
+	}
+
+	SECTION("Incremental refresh")
+	{
+		auto index = index_t { bitset };
+
+		const auto previous_count = index.count();
+
+		bitset.enable(1);
+		index.invalidate(1);
+
+		bitset.disable(((bitset_t::page_stride * 2) - 1));
+		index.invalidate(((bitset_t::page_stride * 2) - 1));
+
+		bitset.speculative_enable((n_bits + 10));
+
+		index.refresh();
+
+		REQUIRE(index.size() == (n_bits + 11));
+		REQUIRE(index.count() == (previous_count + 1));
+		REQUIRE(index.rank(2) == 2);
+		REQUIRE(index.select(1) == 1);
+		REQUIRE(index.select((index.count() - 1)) == (n_bits + 10));
+	}
+}
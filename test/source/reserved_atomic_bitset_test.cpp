@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/reserved_atomic_bitset.hpp>
+
+#include <thread>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::reserved_atomic_bitset", "[reserved-atomic-bitset]")
+{
+	using bitset_t = immutableoctet::reserved_atomic_bitset;
+
+	SECTION("Growth within the reservation")
+	{
+		auto bitset = bitset_t {};
+
+		REQUIRE(bitset.empty());
+		REQUIRE(bitset.capacity() == 0);
+		REQUIRE(bitset.max_size() >= bitset_t::default_reserved_size);
+		REQUIRE(!bitset.get(12345));
+
+		bitset[10] = true;
+
+		REQUIRE(bitset.size() == 11);
+		REQUIRE(bitset.capacity() >= 11);
+
+		const auto* first_word = bitset.try_get_word(0);
+
+		// Growing far beyond the first chunk must not move existing words.
+		bitset.speculative_enable(1'000'000'000);
+
+		REQUIRE(bitset.size() == 1'000'000'001);
+		REQUIRE(bitset.try_get_word(0) == first_word);
+		REQUIRE(bitset[10]);
+		REQUIRE(bitset[1'000'000'000]);
+		REQUIRE(!bitset[999'999'999]);
+
+		bitset.clear();
+
+		REQUIRE(bitset.empty());
+		REQUIRE(!bitset.get(10));
+	}
+
+	SECTION("Simultaneous access")
+	{
+		auto bitset = bitset_t {};
+
+		constexpr std::size_t n_elements = 4096 * 64;
+
+		auto work = [&bitset](std::size_t offset)
+		{
+			for (std::size_t index = offset; index < n_elements; index += 3)
+			{
+				bitset.speculative_enable(index);
+			}
+		};
+
+		{
+			auto first = std::jthread { work, 0 };
+			auto second = std::jthread { work, 1 };
+			auto third = std::jthread { work, 2 };
+		}
+
+		std::size_t sum_of_bits = 0;
+
+		for (std::size_t index = 0; index < bitset.size(); index++)
+		{
+			sum_of_bits += static_cast<std::size_t>(bitset.get(index));
+		}
+
+		REQUIRE(sum_of_bits == n_elements);
+	}
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/ring_atomic_bitset.hpp>
+
+#include <thread>
+#include <atomic>
+#include <limits>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::ring_atomic_bitset", "[ring-atomic-bitset]")
+{
+	using ring_t = immutableoctet::ring_atomic_bitset;
+	using result_t = ring_t::insert_result;
+
+	SECTION("Sliding window")
+	{
+		auto ring = ring_t { 4 };
+
+		REQUIRE(ring.capacity() == (ring_t::page_stride * 4));
+
+		REQUIRE(ring.test_and_set(10) == result_t::inserted);
+		REQUIRE(ring.test_and_set(10) == result_t::duplicate);
+		REQUIRE(ring[10]);
+		REQUIRE(!ring[11]);
+
+		// Moving past the end of the window slides it forward, retiring the first page.
+		const auto far_index = (ring_t::page_stride * 4) + 5;
+
+		REQUIRE(ring.test_and_set(far_index) == result_t::inserted);
+		REQUIRE(ring.base() == ring_t::page_stride);
+		REQUIRE(ring.test_and_set(10) == result_t::too_old);
+		REQUIRE(!ring[10]);
+
+		// The recycled slot must not leak the retired page's bits.
+		REQUIRE(!ring[(ring_t::page_stride * 4) + 10]);
+
+		ring.advance_base((far_index + 1));
+
+		REQUIRE(ring.test_and_set(far_index) == result_t::too_old);
+		REQUIRE(ring.advance_base(0) == (far_index + 1));
+
+		// Page tags count revolutions of the ring, so large windows cover every 64-bit index.
+		REQUIRE(ring.max_index() == ((ring.capacity() * ring_t::max_page_tag) - 1));
+		REQUIRE(ring_t { 8 }.max_index() == std::numeric_limits<std::uint64_t>::max());
+
+		const auto last_index = ring.max_index();
+
+		REQUIRE(ring.test_and_set(last_index) == result_t::inserted);
+		REQUIRE(ring.test_and_set(last_index) == result_t::duplicate);
+		REQUIRE(ring.test_and_set((last_index - ring.capacity())) == result_t::too_old);
+	}
+
+	SECTION("Simultaneous deduplication")
+	{
+		auto ring = ring_t { 8 };
+
+		constexpr std::uint64_t n_sequences = (ring_t::page_stride * 32);
+
+		std::atomic<std::size_t> inserted = 0;
+		std::atomic<std::size_t> duplicates = 0;
+
+		// Two threads observe the same stream; every sequence number should be inserted exactly once.
+		auto work = [&]()
+		{
+			for (std::uint64_t sequence = 0; sequence < n_sequences; sequence++)
+			{
+				auto result = ring.test_and_set(sequence);
+
+				// The other thread may still be using (or clearing) the slot; retry rather than dropping the sequence number.
+				while (result == result_t::busy)
+				{
+					result = ring.test_and_set(sequence);
+				}
+
+				switch (result)
+				{
+					case result_t::inserted:
+						inserted++;
+
+						break;
+
+					case result_t::duplicate:
+						duplicates++;
+
+						break;
+
+					default:
+						break;
+				}
+			}
+		};
+
+		{
+			auto first = std::jthread { work };
+			auto second = std::jthread { work };
+		}
+
+		REQUIRE(inserted == n_sequences);
+		REQUIRE(duplicates <= n_sequences);
+	}
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/sharded_atomic_bitset.hpp>
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::sharded_atomic_bitset", "[sharded-atomic-bitset]")
+{
+	using bitset_t = immutableoctet::sharded_atomic_bitset;
+
+	constexpr auto page_stride = bitset_t::page_stride;
+
+	SECTION("Index mapping")
+	{
+		auto bitset = bitset_t { 4 };
+
+		REQUIRE(bitset.shard_count() == 4);
+
+		REQUIRE(bitset.resolve_shard_index(5) == 0);
+		REQUIRE(bitset.resolve_shard_index((page_stride + 5)) == 1);
+		REQUIRE(bitset.resolve_shard_index(((page_stride * 5) + 5)) == 1);
+		REQUIRE(bitset.resolve_local_index(((page_stride * 5) + 5)) == (page_stride + 5));
+		REQUIRE(bitset.resolve_global_index(1, (page_stride + 5)) == ((page_stride * 5) + 5));
+
+		// Each shard holds its share of the requested size.
+		bitset.resize(((page_stride * 5) + 10));
+
+		REQUIRE(bitset.size() == ((page_stride * 5) + 10));
+		REQUIRE(bitset.get_shard(0).size() == (page_stride * 2));
+		REQUIRE(bitset.get_shard(1).size() == (page_stride + 10));
+		REQUIRE(bitset.get_shard(2).size() == page_stride);
+		REQUIRE(bitset.get_shard(3).size() == page_stride);
+	}
+
+	SECTION("Concurrent growth")
+	{
+		auto bitset = bitset_t { 8 };
+
+		constexpr auto thread_count = std::size_t { 8 };
+		constexpr auto pages_per_thread = std::size_t { 4 };
+
+		// Each thread writes to the pages owned by its own shard, growing it independently of the others.
+		auto for_each_owned_index = [](std::size_t thread_index, auto&& callback)
+		{
+			for (std::size_t round = 0; round < pages_per_thread; round++)
+			{
+				const auto page_begin = (((round * thread_count) + thread_index) * page_stride);
+
+				for (std::size_t index = (page_begin + thread_index); index < (page_begin + page_stride); index += 3)
+				{
+					callback(index);
+				}
+			}
+		};
+
+		{
+			auto workers = std::vector<std::jthread> {};
+
+			for (std::size_t thread_index = 0; thread_index < thread_count; thread_index++)
+			{
+				workers.emplace_back
+				(
+					[&bitset, &for_each_owned_index, thread_index]()
+					{
+						for_each_owned_index
+						(
+							thread_index,
+
+							[&bitset](std::size_t index)
+							{
+								bitset.speculative_enable(index);
+							}
+						);
+					}
+				);
+			}
+		}
+
+		auto expected = std::vector<std::size_t> {};
+
+		for (std::size_t thread_index = 0; thread_index < thread_count; thread_index++)
+		{
+			for_each_owned_index
+			(
+				thread_index,
+
+				[&expected](std::size_t index)
+				{
+					expected.push_back(index);
+				}
+			);
+		}
+
+		std::sort(expected.begin(), expected.end());
+
+		REQUIRE(bitset.count() == expected.size());
+		REQUIRE(bitset.size() == (expected.back() + 1));
+
+		auto visited = std::vector<std::size_t> {};
+
+		bitset.for_each_enabled
+		(
+			[&visited](std::size_t index)
+			{
+				visited.push_back(index);
+			}
+		);
+
+		REQUIRE(visited == expected);
+
+		REQUIRE(bitset.get(expected[10]));
+		REQUIRE(!bitset.get(thread_count));
+
+		bitset.disable(expected[10]);
+
+		REQUIRE(!bitset.get(expected[10]));
+		REQUIRE(bitset.count() == (expected.size() - 1));
+	}
+}
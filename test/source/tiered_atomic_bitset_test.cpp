@@ -0,0 +1,211 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <immutableoctet/atomic_bitset/tiered_atomic_bitset.hpp>
+
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("immutableoctet::tiered_atomic_bitset", "[tiered-atomic-bitset]")
+{
+	using bitset_t = immutableoctet::tiered_atomic_bitset;
+	using immutableoctet::page_tier;
+
+	constexpr auto page_stride = bitset_t::page_stride;
+
+	SECTION("Compression of cold pages")
+	{
+		auto bitset = bitset_t { (page_stride * 6) };
+		auto expected = std::vector<bool>((page_stride * 6));
+
+		REQUIRE(bitset.memory_usage().all_zero.pages == 6);
+		REQUIRE(bitset.memory_usage().total_bytes() == 0);
+
+		// Reading untouched pages doesn't allocate them.
+		REQUIRE(!bitset.get(12345));
+		REQUIRE(bitset.get_page_tier(0) == page_tier::all_zero);
+
+		auto enable = [&bitset, &expected](std::size_t index)
+		{
+			bitset.enable(index);
+			expected[index] = true;
+		};
+
+		// Page 0: a handful of scattered bits.
+		for (std::size_t index = 0; index < page_stride; index += 1000)
+		{
+			enable(index);
+		}
+
+		// Page 1: a few long runs.
+		for (std::size_t index = (page_stride + 100); index < (page_stride + 5000); index++)
+		{
+			enable(index);
+		}
+
+		for (std::size_t index = (page_stride + 20000); index < (page_stride * 2); index++)
+		{
+			enable(index);
+		}
+
+		// Page 2: every bit.
+		for (std::size_t index = (page_stride * 2); index < (page_stride * 3); index++)
+		{
+			enable(index);
+		}
+
+		// Page 3: too noisy to compress.
+		for (std::size_t index = (page_stride * 3); index < (page_stride * 4); index += 3)
+		{
+			enable(index);
+		}
+
+		// Page 4: written, then cleared.
+		bitset.enable((page_stride * 4));
+		bitset.disable((page_stride * 4));
+
+		REQUIRE(bitset.memory_usage().resident.pages == 5);
+
+		// Pages accessed during the current epoch are left alone.
+		REQUIRE(bitset.compress_cold_pages(1) == 0);
+
+		bitset.advance_epoch();
+
+		REQUIRE(bitset.compress_cold_pages(1) == 4);
+
+		REQUIRE(bitset.get_page_tier(0) == page_tier::sparse);
+		REQUIRE(bitset.get_page_tier(1) == page_tier::run_length);
+		REQUIRE(bitset.get_page_tier(2) == page_tier::all_one);
+		REQUIRE(bitset.get_page_tier(3) == page_tier::resident);
+		REQUIRE(bitset.get_page_tier(4) == page_tier::all_zero);
+
+		const auto usage = bitset.memory_usage();
+
+		REQUIRE(usage.resident.pages == 1);
+		REQUIRE(usage.all_zero.pages == 2);
+		REQUIRE(usage.all_one.bytes == 0);
+		REQUIRE(usage.sparse.bytes > 0);
+		REQUIRE(usage.sparse.bytes <= bitset_t::max_encoded_size);
+		REQUIRE(usage.run_length.bytes <= bitset_t::max_encoded_size);
+
+		// Encodings don't hold on to spare capacity: four runs, and one position per enabled bit.
+		REQUIRE(usage.run_length.bytes == (4 * sizeof(bitset_t::position_type)));
+		REQUIRE(usage.sparse.bytes == (((page_stride + 999) / 1000) * sizeof(bitset_t::position_type)));
+
+		// Uniform pages are read in place; other pages are expanded on access.
+		REQUIRE(bitset.get(((page_stride * 2) + 7)));
+		REQUIRE(bitset.get_page_tier(2) == page_tier::all_one);
+
+		for (std::size_t index = 0; index < expected.size(); index++)
+		{
+			REQUIRE(bitset.get(index) == expected[index]);
+		}
+
+		REQUIRE(bitset.get_page_tier(0) == page_tier::resident);
+		REQUIRE(bitset.get_page_tier(1) == page_tier::resident);
+
+		bitset.disable(((page_stride * 2) + 7));
+
+		REQUIRE(bitset.get_page_tier(2) == page_tier::resident);
+		REQUIRE(!bitset.get(((page_stride * 2) + 7)));
+		REQUIRE(bitset.get(((page_stride * 2) + 8)));
+	}
+
+	SECTION("Reads during compression")
+	{
+		auto bitset = bitset_t { (page_stride * 2) };
+
+		for (std::size_t index = 0; index < (page_stride * 2); index += 1000)
+		{
+			bitset.enable(index);
+		}
+
+		auto mismatches = std::atomic<std::size_t> { 0 };
+		auto compressed_pages = std::size_t {};
+
+		{
+			auto readers = std::vector<std::jthread> {};
+
+			for (std::size_t reader_index = 0; reader_index < 4; reader_index++)
+			{
+				readers.emplace_back
+				(
+					[&bitset, &mismatches, reader_index]()
+					{
+						for (std::size_t iteration = 0; iteration < 200000; iteration++)
+						{
+							const auto index = (((iteration * 13) + reader_index) % (page_stride * 2));
+
+							if (bitset.get(index) != ((index % 1000) == 0))
+							{
+								mismatches++;
+							}
+						}
+					}
+				);
+			}
+
+			// Pages are compressed (and their memory released) while they're being read.
+			for (std::size_t round = 0; round < 200; round++)
+			{
+				compressed_pages += bitset.compress_cold_pages(0);
+			}
+		}
+
+		REQUIRE(compressed_pages > 0);
+		REQUIRE(mismatches == 0);
+	}
+
+	SECTION("Background sweeping")
+	{
+		auto bitset = bitset_t { (page_stride * 4) };
+
+		for (std::size_t page_index = 0; page_index < 4; page_index++)
+		{
+			bitset.enable(((page_index * page_stride) + page_index));
+		}
+
+		{
+			auto workers = std::vector<std::jthread> {};
+
+			for (std::size_t page_index = 0; page_index < 4; page_index++)
+			{
+				workers.emplace_back
+				(
+					[&bitset, page_index]()
+					{
+						for (std::size_t iteration = 0; iteration < (64 * 300); iteration++)
+						{
+							bitset.toggle(((page_index * page_stride) + 100 + (iteration % 64)));
+						}
+					}
+				);
+			}
+
+			bitset.start_sweeper(std::chrono::milliseconds { 1 }, 1);
+		}
+
+		const auto deadline = (std::chrono::steady_clock::now() + std::chrono::seconds { 10 });
+
+		while ((bitset.memory_usage().resident.pages > 0) && (std::chrono::steady_clock::now() < deadline))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+		}
+
+		bitset.stop_sweeper();
+
+		REQUIRE(bitset.memory_usage().resident.pages == 0);
+
+		// Each page toggled every bit of its range an even number of times.
+		for (std::size_t page_index = 0; page_index < 4; page_index++)
+		{
+			REQUIRE(bitset.get(((page_index * page_stride) + page_index)));
+			REQUIRE(!bitset.get(((page_index * page_stride) + 100)));
+			REQUIRE(!bitset.get(((page_index * page_stride) + 163)));
+		}
+	}
+}